@@ -10,7 +10,7 @@
 // Константа для имени файла курса
 static const QString COURSE_DATA_FILE = "course.dat";
 
-AdminWidget::AdminWidget(Course* course, QWidget* parent)
+AdminWidget::AdminWidget(const SharedCoursePtr& course, QWidget* parent)
     : QWidget(parent)
     , m_course(course)
     , m_statisticsModel(nullptr)
@@ -29,6 +29,66 @@ AdminWidget::AdminWidget(Course* course, QWidget* parent)
     loadTopics();
 }
 
+void AdminWidget::setCourse(const SharedCoursePtr& course) {
+    if (!course || course == m_course) {
+        return;
+    }
+    m_course = course;
+    if (isEnabled()) {
+        loadTopics();
+    }
+}
+
+void AdminWidget::insertTopic(const SharedCoursePtr& course, int index) {
+    if (!course) {
+        return;
+    }
+    m_course = course;
+    if (!isEnabled()) {
+        return;
+    }
+
+    // Текущая тема не меняется, поэтому редактор не перечитывается
+    m_cbTopics->blockSignals(true);
+    m_cbTopics->insertItem(index, m_course->topicTitle(index));
+    m_cbTopics->blockSignals(false);
+}
+
+void AdminWidget::removeTopic(const SharedCoursePtr& course, int index) {
+    if (!course) {
+        return;
+    }
+    m_course = course;
+    if (!isEnabled()) {
+        return;
+    }
+
+    const bool wasCurrent = m_cbTopics->currentIndex() == index;
+    m_cbTopics->blockSignals(true);
+    m_cbTopics->removeItem(index);
+    m_cbTopics->blockSignals(false);
+    if (wasCurrent) {
+        onTopicChanged(m_cbTopics->currentIndex());
+    }
+}
+
+void AdminWidget::updateTopic(const SharedCoursePtr& course, int index, bool contentChanged) {
+    if (!course) {
+        return;
+    }
+
+    // Правка, сохраненная этой панелью, уже отражена в редакторе
+    const bool ownEdit = course == m_course;
+    m_course = course;
+    if (!isEnabled()) {
+        return;
+    }
+    m_cbTopics->setItemText(index, m_course->topicTitle(index));
+    if (contentChanged && !ownEdit && m_cbTopics->currentIndex() == index) {
+        onTopicChanged(index);
+    }
+}
+
 void AdminWidget::setCurrentUser(const User& user) {
     m_currentUser = user;
     setupAccessRights();
@@ -154,9 +214,7 @@ void AdminWidget::loadTopics() {
     m_cbTopics->blockSignals(true);
     m_cbTopics->clear();
 
-    for (const Topic& topic : m_course->topics) {
-        m_cbTopics->addItem(topic.title);
-    }
+    m_cbTopics->addItems(m_course->topicTitles());
 
     m_cbTopics->blockSignals(false);
 
@@ -167,19 +225,29 @@ void AdminWidget::loadTopics() {
 }
 
 void AdminWidget::onTopicChanged(int index) {
-    if (!m_course || index < 0 || index >= m_course->topics.size()) {
+    if (!m_course || index < 0 || index >= m_course->topicCount()) {
+        m_txtHtmlEditor->clear();
+        return;
+    }
+
+    TopicPtr topic;
+    try {
+        topic = m_course->topic(index);
+    } catch (const std::exception& e) {
         m_txtHtmlEditor->clear();
+        QMessageBox::critical(this, "Ошибка загрузки",
+                              QString("Не удалось загрузить тему:\n%1").arg(e.what()));
         return;
     }
 
-    m_txtHtmlEditor->setPlainText(m_course->topics[index].htmlContent);
+    m_txtHtmlEditor->setPlainText(topic->htmlContent);
 }
 
 void AdminWidget::onSaveClicked() {
     if (!m_course) return;
 
     int index = m_cbTopics->currentIndex();
-    if (index < 0 || index >= m_course->topics.size()) {
+    if (index < 0 || index >= m_course->topicCount()) {
         QMessageBox::warning(this, "Ошибка", "Нет выбранной темы для сохранения.");
         return;
     }
@@ -190,9 +258,14 @@ void AdminWidget::onSaveClicked() {
             QMessageBox::warning(this, "Предупреждение", "Текст лекции пуст!");
             return;
         }
-        m_course->topics[index].htmlContent = newContent;
-
-        Serializer::save(*m_course, COURSE_DATA_FILE);
+        // Правка создает новый снимок; остальные темы разделяются с прежним
+        Topic edited = *m_course->topic(index);
+        edited.htmlContent = newContent;
+        const SharedCoursePtr updated = m_course->withTopic(index, edited);
+
+        Serializer::saveTopic(updated->toCourse(), index, COURSE_DATA_FILE);
+        m_course = updated;
+        emit courseChanged(m_course);
         QMessageBox::information(this, "Успех", "Курс успешно сохранен и зашифрован!");
 
     } catch (const std::exception& e) {
@@ -2,6 +2,7 @@
 
 #include "DomainTypes.h"
 #include "Serializer.h"
+#include "SharedCourse.h"
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -31,10 +32,38 @@ class AdminWidget : public QWidget {
 public:
     /**
      * @brief Конструктор виджета администрирования.
-     * @param course Указатель на курс для редактирования.
+     * @param course Общий снимок курса для редактирования.
      * @param parent Родительский виджет.
      */
-    explicit AdminWidget(Course* course, QWidget* parent = nullptr);
+    explicit AdminWidget(const SharedCoursePtr& course, QWidget* parent = nullptr);
+
+    /**
+     * @brief Заменяет редактируемый снимок курса (например, после перезагрузки файла).
+     * @param course Новый снимок курса.
+     */
+    void setCourse(const SharedCoursePtr& course);
+
+    /**
+     * @brief Добавляет тему нового снимка в список редактора.
+     * @param course Снимок курса с добавленной темой.
+     * @param index Индекс добавленной темы.
+     */
+    void insertTopic(const SharedCoursePtr& course, int index);
+
+    /**
+     * @brief Удаляет тему из списка редактора.
+     * @param course Снимок курса без темы.
+     * @param index Индекс удаленной темы.
+     */
+    void removeTopic(const SharedCoursePtr& course, int index);
+
+    /**
+     * @brief Обновляет одну тему в списке редактора.
+     * @param course Снимок курса с измененной темой.
+     * @param index Индекс темы.
+     * @param contentChanged Изменилась ли теория (перечитывается, если тема открыта).
+     */
+    void updateTopic(const SharedCoursePtr& course, int index, bool contentChanged);
 
     /**
      * @brief Устанавливает текущего пользователя для проверки прав доступа.
@@ -48,6 +77,12 @@ signals:
      */
     void backRequested();
 
+    /**
+     * @brief Сигнал о новом снимке курса после сохранения правки.
+     * @param course Снимок курса с измененной темой.
+     */
+    void courseChanged(const SharedCoursePtr& course);
+
 private slots:
     /**
      * @brief Обработчик изменения выбранной темы.
@@ -107,7 +142,7 @@ private:
     void setupAccessRights();
 
     // Данные
-    Course* m_course;
+    SharedCoursePtr m_course;
     User m_currentUser;
 
     // Основные элементы интерфейса
@@ -7,6 +7,9 @@
 #include "StudentProfileWidget.h"
 #include "DatabaseManager.h"
 #include "ProgressDao.h"
+#include "DbExecutor.h"
+#include "ProgressWriter.h"
+#include "TestResultQueue.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QMessageBox>
@@ -76,13 +79,49 @@ void AppController::setupViews() {
     m_stackedWidget->addWidget(m_profileWidget);
     
     // Настройка виджета выбора тем
-    m_topicWidget->setTopics(m_courseModel->getTopics());
+    m_topicWidget->setCourse(m_courseModel->getCourse());
+    m_sessionManager.setCourse(m_courseModel->getCourse());
 }
 
 void AppController::connectSignals() {
     // Подключение сигналов модели курса
     connect(m_courseModel, &CourseModel::errorOccurred,
             this, &AppController::handleCourseModelError);
+    connect(m_courseModel, &CourseModel::courseDataChanged, this, [this]() {
+        // Все владельцы переходят на новый снимок курса
+        m_sessionManager.setCourse(m_courseModel->getCourse());
+        m_topicWidget->setCourse(m_courseModel->getCourse());
+        if (m_adminWidget) {
+            m_adminWidget->setCourse(m_courseModel->getCourse());
+        }
+    });
+
+    // Правка одной темы обновляет одну строку в представлениях
+    connect(m_courseModel, &CourseModel::topicInserted, this, [this](int index) {
+        const SharedCoursePtr course = m_courseModel->getCourse();
+        m_sessionManager.setCourse(course);
+        m_topicWidget->insertTopic(course, index);
+        if (m_adminWidget) {
+            m_adminWidget->insertTopic(course, index);
+        }
+    });
+    connect(m_courseModel, &CourseModel::topicRemoved, this, [this](int index) {
+        const SharedCoursePtr course = m_courseModel->getCourse();
+        m_sessionManager.setCourse(course);
+        m_topicWidget->removeTopic(course, index);
+        if (m_adminWidget) {
+            m_adminWidget->removeTopic(course, index);
+        }
+    });
+    connect(m_courseModel, &CourseModel::topicChanged, this,
+            [this](int index, CourseModel::TopicFields fields) {
+                const SharedCoursePtr course = m_courseModel->getCourse();
+                m_sessionManager.setCourse(course);
+                m_topicWidget->updateTopic(course, index);
+                if (m_adminWidget) {
+                    m_adminWidget->updateTopic(course, index, fields.testFlag(CourseModel::ContentField));
+                }
+            });
     
     // Подключение сигналов модели результатов
     connect(m_testResultsModel, &TestResultsModel::databaseError,
@@ -95,6 +134,10 @@ void AppController::connectSignals() {
     // Подключение сигналов виджета выбора тем
     connect(m_topicWidget, &TopicSelectionWidget::topicSelected,
             this, &AppController::handleTopicSelected);
+    connect(m_topicWidget, &TopicSelectionWidget::topicHighlighted,
+            this, [this](int topicIndex) { prefetchTopicDocuments(topicIndex, true); });
+    connect(m_topicWidget, &TopicSelectionWidget::searchResultSelected,
+            this, &AppController::handleSearchResultSelected);
     connect(m_topicWidget, &TopicSelectionWidget::logoutRequested,
             this, &AppController::handleLogout);
     connect(m_topicWidget, &TopicSelectionWidget::profileRequested,
@@ -135,42 +178,46 @@ void AppController::handleUserAuthenticated(const User& user) {
     if (user.isAdmin()) {
         // Создаем виджет администратора при необходимости
         if (!m_adminWidget) {
-            // Для администратора создаем виджет без прямого доступа к данным курса
-            m_adminWidget = new AdminWidget(nullptr, m_stackedWidget);
+            // Панель администратора разделяет снимок курса с моделью
+            m_adminWidget = new AdminWidget(m_courseModel->getCourse(), m_stackedWidget);
             m_stackedWidget->addWidget(m_adminWidget);
             
             connect(m_adminWidget, &AdminWidget::backRequested,
                     this, &AppController::handleAdminBack);
+            connect(m_adminWidget, &AdminWidget::courseChanged,
+                    m_courseModel, &CourseModel::setCourse);
         }
         
         m_adminWidget->setCurrentUser(user);
         switchToView(m_adminWidget);
     } else {
-        // Загружаем прогресс студента
-        int lastTopicId = loadStudentProgress(user.id);
-        if (lastTopicId >= 0) {
-            m_topicWidget->setLastStudiedTopic(lastTopicId);
-        }
-        
         switchToView(m_topicWidget);
+
+        // Прогресс студента подгружается в фоне
+        loadStudentProgress(user.id);
     }
 }
 
 void AppController::handleLogout() {
+    // Результаты и прогресс вышедшего пользователя не ждут таймера
+    TestResultQueue::instance().flush();
+    ProgressWriter::instance().flush();
     m_sessionManager.clearSession();
     switchToView(m_loginWidget);
 }
 
 void AppController::handleTopicSelected(int topicIndex) {
-    const Topic* topic = m_courseModel->getTopic(topicIndex);
+    TopicPtr topic = m_courseModel->getTopic(topicIndex);
     if (!topic) {
         emit errorOccurred("Тема не найдена");
         return;
     }
     
     m_currentTopicIndex = topicIndex;
+    m_topicViewWidget->setCourse(m_courseModel->getCourse());
     m_topicViewWidget->showTopic(*topic, topicIndex);
     switchToView(m_topicViewWidget);
+    prefetchTopicDocuments(topicIndex, false);
     
     // Сохраняем прогресс студента
     User currentUser = m_sessionManager.getCurrentUser();
@@ -179,8 +226,15 @@ void AppController::handleTopicSelected(int topicIndex) {
     }
 }
 
+void AppController::handleSearchResultSelected(int topicIndex, int section) {
+    handleTopicSelected(topicIndex);
+    if (m_stackedWidget->currentWidget() == m_topicViewWidget) {
+        m_topicViewWidget->showSection(section);
+    }
+}
+
 void AppController::handleStartTest() {
-    const Topic* topic = m_courseModel->getTopic(m_currentTopicIndex);
+    TopicPtr topic = m_courseModel->getTopic(m_currentTopicIndex);
     if (!topic || topic->questions.isEmpty()) {
         emit errorOccurred("Нет вопросов для тестирования по данной теме");
         return;
@@ -190,7 +244,7 @@ void AppController::handleStartTest() {
 }
 
 void AppController::handleAnswerSubmitted(int answerIndex) {
-    const Topic* topic = m_courseModel->getTopic(m_currentTopicIndex);
+    TopicPtr topic = m_courseModel->getTopic(m_currentTopicIndex);
     if (!topic || m_currentQuestionIndex >= topic->questions.size()) {
         return;
     }
@@ -257,8 +311,22 @@ void AppController::switchToView(QWidget* widget) {
     }
 }
 
+void AppController::prefetchTopicDocuments(int topicIndex, bool includeCenter) {
+    const SharedCoursePtr course = m_courseModel->getCourse();
+    m_topicViewWidget->setCourse(course);
+
+    // Сначала выделенная тема, затем соседние: их откроют с наибольшей вероятностью
+    const int candidates[] = { topicIndex, topicIndex + 1, topicIndex - 1 };
+    for (int candidate : candidates) {
+        if ((candidate == topicIndex && !includeCenter) || candidate < 0 || candidate >= course->topicCount()) {
+            continue;
+        }
+        m_topicViewWidget->prefetchTopic(course, candidate);
+    }
+}
+
 void AppController::startNewTest() {
-    const Topic* topic = m_courseModel->getTopic(m_currentTopicIndex);
+    TopicPtr topic = m_courseModel->getTopic(m_currentTopicIndex);
     if (!topic) {
         return;
     }
@@ -279,7 +347,7 @@ void AppController::startNewTest() {
 void AppController::finishTest() {
     m_testTimer->stop();
     
-    const Topic* topic = m_courseModel->getTopic(m_currentTopicIndex);
+    TopicPtr topic = m_courseModel->getTopic(m_currentTopicIndex);
     if (!topic) {
         return;
     }
@@ -301,7 +369,7 @@ void AppController::finishTest() {
 }
 
 void AppController::showNextQuestion() {
-    const Topic* topic = m_courseModel->getTopic(m_currentTopicIndex);
+    TopicPtr topic = m_courseModel->getTopic(m_currentTopicIndex);
     if (!topic) {
         return;
     }
@@ -316,51 +384,16 @@ void AppController::showNextQuestion() {
     m_testWidget->showQuestion(question);
 }
 
-bool AppController::saveStudentProgress(int userId, int topicId) {
-    DatabaseManager& dbManager = DatabaseManager::instance();
-    if (!dbManager.isConnected()) {
-        return false;
-    }
-    
-    QSqlQuery query(dbManager.database());
-    
-    // Используем INSERT ... ON CONFLICT для PostgreSQL
-    query.prepare(R"(
-        INSERT INTO progress (user_id, last_topic_id, updated_at) 
-        VALUES (?, ?, CURRENT_TIMESTAMP)
-        ON CONFLICT (user_id) 
-        DO UPDATE SET last_topic_id = EXCLUDED.last_topic_id, updated_at = CURRENT_TIMESTAMP
-    )");
-    
-    query.addBindValue(userId);
-    query.addBindValue(topicId);
-    
-    if (!query.exec()) {
-        qWarning() << "Failed to save student progress:" << query.lastError().text();
-        return false;
-    }
-    
-    return true;
+void AppController::saveStudentProgress(int userId, int topicId) {
+    // Прогресс копится в памяти и записывается в БД пачкой
+    ProgressWriter::instance().record(userId, topicId);
 }
 
-int AppController::loadStudentProgress(int userId) {
-    DatabaseManager& dbManager = DatabaseManager::instance();
-    if (!dbManager.isConnected()) {
-        return -1;
-    }
-    
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT last_topic_id FROM progress WHERE user_id = ?");
-    query.addBindValue(userId);
-    
-    if (!query.exec()) {
-        qWarning() << "Failed to load student progress:" << query.lastError().text();
-        return -1;
-    }
-    
-    if (query.next()) {
-        return query.value(0).toInt();
-    }
-    
-    return -1; // Прогресс не найден
-}
\ No newline at end of file
+void AppController::loadStudentProgress(int userId) {
+    // Прогресс подгружается в фоне; ответ для сменившегося пользователя отбрасывается
+    DbExecutor::then(this, m_sessionManager.loadProgressAsync(), [this, userId](int lastTopicId) {
+        if (m_sessionManager.getCurrentUser().id == userId && m_sessionManager.applyProgress(lastTopicId)) {
+            m_topicWidget->setLastStudiedTopic(lastTopicId);
+        }
+    });
+}
@@ -68,6 +68,13 @@ public slots:
      */
     void handleTopicSelected(int topicIndex);
 
+    /**
+     * @brief Обработчик выбора результата поиска: открывает тему на найденном разделе.
+     * @param topicIndex Индекс темы.
+     * @param section Раздел темы.
+     */
+    void handleSearchResultSelected(int topicIndex, int section);
+
     /**
      * @brief Обработчик запуска тестирования.
      */
@@ -146,6 +153,13 @@ private:
      */
     void switchToView(QWidget* widget);
 
+    /**
+     * @brief Заранее готовит документы темы и ее соседей в списке.
+     * @param topicIndex Индекс центральной темы.
+     * @param includeCenter Готовить ли документ самой темы.
+     */
+    void prefetchTopicDocuments(int topicIndex, bool includeCenter);
+
     /**
      * @brief Начинает новый тест для текущего пользователя.
      */
@@ -162,19 +176,17 @@ private:
     void showNextQuestion();
 
     /**
-     * @brief Сохраняет прогресс студента в базу данных.
+     * @brief Передает прогресс студента в ProgressWriter для отложенной записи.
      * @param userId ID пользователя.
      * @param topicId ID последней изученной темы.
-     * @return true, если сохранение прошло успешно.
      */
-    bool saveStudentProgress(int userId, int topicId);
+    void saveStudentProgress(int userId, int topicId);
 
     /**
-     * @brief Загружает прогресс студента из базы данных.
+     * @brief Загружает прогресс студента в фоне, делает последнюю тему текущей в сессии и отмечает ее в списке.
      * @param userId ID пользователя.
-     * @return ID последней изученной темы или -1 при ошибке.
      */
-    int loadStudentProgress(int userId);
+    void loadStudentProgress(int userId);
 
     // Модели данных
     CourseModel* m_courseModel;              ///< Модель данных курса
@@ -1,5 +1,6 @@
 #include "AuthService.h"
 #include "DatabaseManager.h"
+#include "DbExecutor.h"
 #include "Logger.h"
 #include <QCryptographicHash>
 #include <QByteArray>
@@ -22,8 +23,7 @@ AuthService::AuthResult AuthService::login(const QString& login, const QString&
     }
 
     // Подготовка запроса для поиска пользователя
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT id, login, password_hash, full_name, role FROM users WHERE login = ?");
+    QSqlQuery query = dbManager.preparedQuery("SELECT id, login, password_hash, full_name, role FROM users WHERE login = ?");
     query.addBindValue(login.trimmed());
 
     if (!query.exec()) {
@@ -85,8 +85,7 @@ AuthService::RegisterResult AuthService::registerUser(const QString& login, cons
     }
 
     // Проверка существования пользователя
-    QSqlQuery checkQuery(dbManager.database());
-    checkQuery.prepare("SELECT COUNT(*) FROM users WHERE login = ?");
+    QSqlQuery checkQuery = dbManager.preparedQuery("SELECT COUNT(*) FROM users WHERE login = ?");
     checkQuery.addBindValue(login.trimmed());
     
     if (!checkQuery.exec()) {
@@ -102,8 +101,7 @@ AuthService::RegisterResult AuthService::registerUser(const QString& login, cons
     // Создание нового пользователя
     QString passwordHash = calculateSha256(password);
     
-    QSqlQuery insertQuery(dbManager.database());
-    insertQuery.prepare("INSERT INTO users (login, password_hash, full_name, role) VALUES (?, ?, ?, ?)");
+    QSqlQuery insertQuery = dbManager.preparedQuery("INSERT INTO users (login, password_hash, full_name, role) VALUES (?, ?, ?, ?)");
     insertQuery.addBindValue(login.trimmed());
     insertQuery.addBindValue(passwordHash);
     insertQuery.addBindValue(fullName.trimmed());
@@ -124,6 +122,25 @@ bool AuthService::checkAdminPassword(const QString& password) {
     return result == AuthResult::Success && user.isAdmin();
 }
 
+QFuture<AuthService::LoginOutcome> AuthService::loginAsync(const QString& login, const QString& password) {
+    return DbExecutor::run([login, password]() {
+        LoginOutcome outcome;
+        outcome.result = AuthService::login(login, password, outcome.user);
+        return outcome;
+    });
+}
+
+QFuture<AuthService::RegisterResult> AuthService::registerUserAsync(const QString& login, const QString& password,
+                                                                    const QString& fullName, const QString& role) {
+    return DbExecutor::run([login, password, fullName, role]() {
+        return registerUser(login, password, fullName, role);
+    });
+}
+
+QFuture<bool> AuthService::checkAdminPasswordAsync(const QString& password) {
+    return DbExecutor::run([password]() { return checkAdminPassword(password); });
+}
+
 QString AuthService::calculateSha256(const QString& input) {
     QByteArray hashBytes = QCryptographicHash::hash(
         input.toUtf8(),
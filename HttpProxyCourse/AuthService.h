@@ -2,6 +2,7 @@
 
 #include "DomainTypes.h"
 #include <QString>
+#include <QFuture>
 #include <QSqlError>
 
 /**
@@ -31,6 +32,14 @@ public:
         DatabaseError       ///< Ошибка базы данных
     };
 
+    /**
+     * @brief Результат асинхронной аутентификации.
+     */
+    struct LoginOutcome {
+        AuthResult result = AuthResult::DatabaseError; ///< Результат аутентификации
+        User user;                                     ///< Данные пользователя при успехе
+    };
+
     /**
      * @brief Аутентификация пользователя.
      * @param login Логин пользователя.
@@ -58,6 +67,27 @@ public:
      */
     static bool checkAdminPassword(const QString& password);
 
+    /**
+     * @brief Асинхронная аутентификация: запрос выполняется в пуле потоков БД.
+     * @param login Логин пользователя.
+     * @param password Пароль в открытом виде.
+     * @return Future с результатом и данными пользователя.
+     */
+    static QFuture<LoginOutcome> loginAsync(const QString& login, const QString& password);
+
+    /**
+     * @brief Асинхронная регистрация (см. registerUser()).
+     * @return Future с результатом регистрации.
+     */
+    static QFuture<RegisterResult> registerUserAsync(const QString& login, const QString& password,
+                                                     const QString& fullName, const QString& role = "student");
+
+    /**
+     * @brief Асинхронная проверка пароля администратора (см. checkAdminPassword()).
+     * @return Future с результатом проверки.
+     */
+    static QFuture<bool> checkAdminPasswordAsync(const QString& password);
+
     /**
      * @brief Проверяет силу пароля.
      * @param password Пароль для проверки.
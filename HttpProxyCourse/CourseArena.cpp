@@ -0,0 +1,165 @@
+#include "CourseArena.h"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+/// @brief Символ замены для некорректных последовательностей UTF-8.
+constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+/**
+ * @brief Декодирует один символ UTF-8 и сдвигает указатель за него.
+ */
+char32_t decodeCodePoint(const uchar*& pos, const uchar* end) {
+    const uchar lead = *pos++;
+    if (lead < 0x80) {
+        return lead;
+    }
+
+    int extra = 0;
+    char32_t codePoint = 0;
+    char32_t minimum = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1;
+        codePoint = lead & 0x1F;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        extra = 2;
+        codePoint = lead & 0x0F;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        extra = 3;
+        codePoint = lead & 0x07;
+        minimum = 0x10000;
+    } else {
+        return ReplacementCharacter;
+    }
+
+    if (end - pos < extra) {
+        return ReplacementCharacter;
+    }
+    for (int i = 0; i < extra; ++i) {
+        if ((pos[i] & 0xC0) != 0x80) {
+            return ReplacementCharacter;
+        }
+        codePoint = (codePoint << 6) | (pos[i] & 0x3F);
+    }
+    pos += extra;
+
+    // Избыточные формы, суррогаты и значения за пределами Unicode
+    if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        return ReplacementCharacter;
+    }
+    return codePoint;
+}
+
+/**
+ * @brief Варианты ответов по умолчанию для вопроса без вариантов.
+ */
+const QStringView DefaultVariants[] = { QStringView(u"Да"), QStringView(u"Нет") };
+
+} // namespace
+
+// ==================== CourseArena ====================
+
+void* CourseArena::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t padding = static_cast<std::size_t>(-reinterpret_cast<std::uintptr_t>(m_pos)) & (alignment - 1);
+    if (!m_pos || size + padding > static_cast<std::size_t>(m_end - m_pos)) {
+        // Крупные строки (теория тем) получают собственный блок
+        const std::size_t chunkSize = qMax(ChunkSize, size + alignment);
+        m_chunks.emplace_back(new char[chunkSize]);
+        m_pos = m_chunks.back().get();
+        m_end = m_pos + chunkSize;
+        m_bytesAllocated += chunkSize;
+        padding = static_cast<std::size_t>(-reinterpret_cast<std::uintptr_t>(m_pos)) & (alignment - 1);
+    }
+
+    void* result = m_pos + padding;
+    m_pos += padding + size;
+    return result;
+}
+
+QStringView CourseArena::copy(QStringView text) {
+    if (text.isEmpty()) {
+        return QStringView();
+    }
+
+    const std::size_t bytes = static_cast<std::size_t>(text.size()) * sizeof(char16_t);
+    char16_t* data = static_cast<char16_t*>(allocate(bytes, alignof(char16_t)));
+    std::memcpy(data, text.utf16(), bytes);
+    return QStringView(data, text.size());
+}
+
+QStringView CourseArena::copyUtf8(const char* data, int size) {
+    if (size <= 0) {
+        return QStringView();
+    }
+
+    const uchar* begin = reinterpret_cast<const uchar*>(data);
+    const uchar* end = begin + size;
+
+    // Первый проход считает UTF-16 единицы, чтобы не занимать в арене лишнего
+    qsizetype length = 0;
+    for (const uchar* pos = begin; pos != end;) {
+        length += decodeCodePoint(pos, end) > 0xFFFF ? 2 : 1;
+    }
+
+    char16_t* out = static_cast<char16_t*>(allocate(static_cast<std::size_t>(length) * sizeof(char16_t),
+                                                    alignof(char16_t)));
+    char16_t* dst = out;
+    for (const uchar* pos = begin; pos != end;) {
+        const char32_t codePoint = decodeCodePoint(pos, end);
+        if (codePoint > 0xFFFF) {
+            *dst++ = static_cast<char16_t>(0xD7C0 + (codePoint >> 10));
+            *dst++ = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+        } else {
+            *dst++ = static_cast<char16_t>(codePoint);
+        }
+    }
+    return QStringView(out, length);
+}
+
+void CourseArena::release() {
+    m_chunks.clear();
+    m_pos = nullptr;
+    m_end = nullptr;
+    m_bytesAllocated = 0;
+}
+
+// ==================== QuestionView ====================
+
+Question::Validity QuestionView::sanitize() {
+    if (variants.isEmpty()) {
+        variants = ArenaSpan<QStringView>(DefaultVariants, 2);
+        correctIndex = 0;
+        return Question::Validity::EmptyVariants;
+    }
+    if (correctIndex < 0 || correctIndex >= variants.size()) {
+        correctIndex = 0;
+        return Question::Validity::InvalidCorrectIndex;
+    }
+    return Question::Validity::Valid;
+}
+
+// ==================== TopicView ====================
+
+TopicView TopicView::fromTopic(const Topic& topic, CourseArena& arena) {
+    TopicView view;
+    view.title = arena.copy(topic.title);
+    view.htmlContent = arena.copy(topic.htmlContent);
+
+    QuestionView* questions = arena.allocateArray<QuestionView>(topic.questions.size());
+    for (int i = 0; i < topic.questions.size(); ++i) {
+        const Question& question = topic.questions[i];
+        questions[i].text = arena.copy(question.text);
+
+        QStringView* variants = arena.allocateArray<QStringView>(question.variants.size());
+        for (int j = 0; j < question.variants.size(); ++j) {
+            variants[j] = arena.copy(question.variants[j]);
+        }
+        questions[i].variants = ArenaSpan<QStringView>(variants, question.variants.size());
+        questions[i].correctIndex = question.correctIndex;
+    }
+    view.questions = ArenaSpan<QuestionView>(questions, topic.questions.size());
+    return view;
+}
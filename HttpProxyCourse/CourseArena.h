@@ -0,0 +1,129 @@
+#pragma once
+
+#include "DomainTypes.h"
+#include <QStringView>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Непрерывный массив элементов, размещенный в CourseArena.
+ *
+ * Не владеет памятью: действителен, пока жива арена, в которой размещен.
+ */
+template <typename T>
+class ArenaSpan {
+public:
+    ArenaSpan() = default;
+    ArenaSpan(const T* data, int size) : m_data(data), m_size(size) {}
+
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    const T& operator[](int index) const { return m_data[index]; }
+
+private:
+    const T* m_data = nullptr;
+    int m_size = 0;
+};
+
+/**
+ * @brief Монотонный буфер для данных курса.
+ *
+ * Память выделяется последовательно из крупных блоков и не освобождается
+ * по отдельности: все строки и массивы снимка курса уничтожаются разом
+ * вместе с ареной. В арене размещаются только тривиально уничтожаемые типы,
+ * поэтому деструкторы отдельных элементов не вызываются.
+ */
+class CourseArena {
+public:
+    /// @brief Размер очередного блока памяти арены в байтах.
+    static constexpr std::size_t ChunkSize = 64 * 1024;
+
+    CourseArena() = default;
+    CourseArena(const CourseArena&) = delete;
+    CourseArena& operator=(const CourseArena&) = delete;
+
+    /**
+     * @brief Выделяет выровненный участок памяти.
+     * @param size Размер в байтах.
+     * @param alignment Требуемое выравнивание (степень двойки).
+     */
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /**
+     * @brief Размещает массив элементов, инициализированных по умолчанию.
+     * @param count Количество элементов.
+     */
+    template <typename T>
+    T* allocateArray(int count) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "CourseArena never runs destructors of its elements");
+        T* items = static_cast<T*>(allocate(sizeof(T) * static_cast<std::size_t>(count), alignof(T)));
+        for (int i = 0; i < count; ++i) {
+            new (items + i) T();
+        }
+        return items;
+    }
+
+    /**
+     * @brief Копирует строку в арену.
+     */
+    QStringView copy(QStringView text);
+
+    /**
+     * @brief Декодирует UTF-8 прямо в арену, без промежуточного QString.
+     * @note Некорректные последовательности заменяются символом U+FFFD.
+     */
+    QStringView copyUtf8(const char* data, int size);
+
+    /**
+     * @brief Возвращает объем занятой памяти арены в байтах.
+     */
+    std::size_t bytesAllocated() const { return m_bytesAllocated; }
+
+    /**
+     * @brief Освобождает всю память арены одной операцией.
+     */
+    void release();
+
+private:
+    std::vector<std::unique_ptr<char[]>> m_chunks;  ///< Блоки памяти арены
+    char* m_pos = nullptr;                          ///< Начало свободной части текущего блока
+    char* m_end = nullptr;                          ///< Конец текущего блока
+    std::size_t m_bytesAllocated = 0;               ///< Суммарный размер блоков
+};
+
+/**
+ * @brief Вопрос, строки которого размещены в CourseArena.
+ */
+struct QuestionView {
+    QStringView text;                  ///< Текст вопроса
+    ArenaSpan<QStringView> variants;   ///< Варианты ответов
+    qint32 correctIndex = 0;           ///< Индекс правильного ответа
+
+    /**
+     * @brief Исправляет пустой список вариантов и неверный correctIndex
+     *        по тем же правилам, что и Question::sanitize().
+     * @return Что было исправлено.
+     */
+    Question::Validity sanitize();
+};
+
+/**
+ * @brief Тема, строки и вопросы которой размещены в CourseArena.
+ */
+struct TopicView {
+    QStringView title;                  ///< Заголовок темы
+    QStringView htmlContent;            ///< Теория в формате HTML
+    ArenaSpan<QuestionView> questions;  ///< Вопросы по теме
+
+    /**
+     * @brief Копирует загруженную тему в арену.
+     * @param topic Тема с загруженными теорией и вопросами.
+     * @param arena Арена для строк и массивов.
+     */
+    static TopicView fromTopic(const Topic& topic, CourseArena& arena);
+};
@@ -0,0 +1,78 @@
+#include "CourseAssetCache.h"
+#include <QDebug>
+#include <QDir>
+#include <QTextDocument>
+
+CourseAssetCache::CourseAssetCache(int maxCostKb)
+    : m_images(maxCostKb)
+{
+}
+
+bool CourseAssetCache::setCourse(const SharedCoursePtr& course) {
+    const bool storageChanged = !m_course || !course || m_course->storage() != course->storage();
+    m_course = course;
+    if (storageChanged) {
+        m_images.clear();
+    }
+    return storageChanged;
+}
+
+QVariant CourseAssetCache::resource(int type, const QUrl& name) {
+    const QString key = assetName(name);
+    if (!m_course || key.isEmpty()) {
+        return QVariant();
+    }
+
+    if (type == QTextDocument::ImageResource) {
+        if (const QImage* cached = m_images.object(key)) {
+            return *cached;
+        }
+    }
+
+    QByteArray data;
+    try {
+        data = m_course->asset(key);
+    } catch (const std::exception& e) {
+        qWarning() << "Failed to read course asset" << key << ":" << e.what();
+        return QVariant();
+    }
+    if (data.isEmpty()) {
+        return QVariant();
+    }
+
+    if (type == QTextDocument::ImageResource) {
+        // Декодирование читает данные прямо из отображенного файла
+        QImage image;
+        if (!image.loadFromData(data)) {
+            qWarning() << "Failed to decode course asset" << key;
+            return QVariant();
+        }
+        m_images.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+        return image;
+    }
+
+    // Документ хранит загруженные ресурсы у себя, поэтому данные копируются из проекции
+    if (type == QTextDocument::StyleSheetResource || type == QTextDocument::HtmlResource) {
+        return QString::fromUtf8(data);
+    }
+    return QByteArray(data.constData(), data.size());
+}
+
+void CourseAssetCache::clear() {
+    m_images.clear();
+}
+
+QString CourseAssetCache::assetName(const QUrl& name) {
+    if (!name.isRelative()) {
+        return QString();
+    }
+
+    QString path = QDir::cleanPath(name.path());
+    while (path.startsWith(QLatin1String("./"))) {
+        path.remove(0, 2);
+    }
+    if (path.startsWith(QLatin1Char('/'))) {
+        path.remove(0, 1);
+    }
+    return path;
+}
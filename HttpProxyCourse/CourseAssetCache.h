@@ -0,0 +1,61 @@
+#pragma once
+
+#include "SharedCourse.h"
+#include <QCache>
+#include <QImage>
+#include <QString>
+#include <QUrl>
+#include <QVariant>
+
+/**
+ * @brief Ресурсы теории (изображения, таблицы стилей) из контейнера курса.
+ *
+ * Данные ресурсов читаются из отображенного в память контейнера без
+ * копирования; декодированные QImage хранятся в LRU-кэше, ограниченном
+ * объемом пикселей, поэтому повторная отрисовка темы и соседние темы
+ * с теми же схемами не декодируют изображения заново.
+ *
+ * Используется из главного потока (TopicDocument::loadResource()).
+ */
+class CourseAssetCache {
+public:
+    /// @brief Объем декодированных изображений в кэше по умолчанию (в КиБ).
+    static constexpr int DefaultMaxCostKb = 64 * 1024;
+
+    /**
+     * @brief Создает кэш.
+     * @param maxCostKb Предельный объем декодированных изображений (в КиБ).
+     */
+    explicit CourseAssetCache(int maxCostKb = DefaultMaxCostKb);
+
+    /**
+     * @brief Задает курс, из контейнера которого читаются ресурсы.
+     * @param course Снимок курса.
+     * @return true, если сменился контейнер и ранее загруженные ресурсы недействительны.
+     */
+    bool setCourse(const SharedCoursePtr& course);
+
+    /**
+     * @brief Загружает ресурс документа.
+     * @param type Тип ресурса (QTextDocument::ResourceType).
+     * @param name Адрес ресурса из HTML.
+     * @return QImage для изображений, QString для таблиц стилей, QByteArray для прочего;
+     *         недействительный QVariant, если ресурса нет в контейнере.
+     */
+    QVariant resource(int type, const QUrl& name);
+
+    /**
+     * @brief Очищает кэш изображений.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Приводит адрес ресурса к имени в каталоге контейнера.
+     * @return Пустая строка для абсолютных адресов (qrc:, http: и т. п.).
+     */
+    static QString assetName(const QUrl& name);
+
+    SharedCoursePtr m_course;          ///< Курс, из контейнера которого читаются ресурсы
+    QCache<QString, QImage> m_images;  ///< Декодированные изображения (LRU, стоимость — КиБ)
+};
@@ -0,0 +1,329 @@
+#include "CourseCodec.h"
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Последовательная запись varint и строк в буфер.
+ */
+class Writer {
+public:
+    explicit Writer(QByteArray& buffer) : m_buffer(buffer) {}
+
+    void writeVarint(quint64 value) {
+        while (value >= 0x80) {
+            m_buffer.append(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        m_buffer.append(static_cast<char>(value));
+    }
+
+    void writeSignedVarint(qint64 value) {
+        writeVarint((static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+    }
+
+    void writeString(const QString& value) {
+        const QByteArray utf8 = value.toUtf8();
+        writeVarint(static_cast<quint64>(utf8.size()));
+        m_buffer.append(utf8);
+    }
+
+private:
+    QByteArray& m_buffer;
+};
+
+/**
+ * @brief Последовательное чтение varint и строк из непрерывного буфера.
+ *
+ * Не копирует исходные данные: строки создаются напрямую из UTF-8 байтов буфера.
+ */
+class Reader {
+public:
+    explicit Reader(const QByteArray& data)
+        : m_pos(reinterpret_cast<const uchar*>(data.constData()))
+        , m_end(m_pos + data.size())
+    {
+    }
+
+    quint64 readVarint() {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_pos == m_end) {
+                fail();
+            }
+            const uchar byte = *m_pos++;
+            value |= static_cast<quint64>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        fail();
+    }
+
+    qint64 readSignedVarint() {
+        const quint64 value = readVarint();
+        return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+    }
+
+    /**
+     * @brief Читает счетчик элементов, не превышающий оставшийся объем буфера.
+     */
+    int readCount() {
+        const quint64 count = readVarint();
+        if (count > static_cast<quint64>(m_end - m_pos)) {
+            fail();
+        }
+        return static_cast<int>(count);
+    }
+
+    QString readString() {
+        const int size = readCount();
+        const char* begin = reinterpret_cast<const char*>(m_pos);
+        m_pos += size;
+        return QString::fromUtf8(begin, size);
+    }
+
+    void skipString() {
+        m_pos += readCount();
+    }
+
+    /**
+     * @brief Читает строку, декодируя UTF-8 прямо в арену.
+     */
+    QStringView readStringView(CourseArena& arena) {
+        const int size = readCount();
+        const char* begin = reinterpret_cast<const char*>(m_pos);
+        m_pos += size;
+        return arena.copyUtf8(begin, size);
+    }
+
+    bool atEnd() const { return m_pos == m_end; }
+
+    [[noreturn]] static void fail() {
+        throw std::runtime_error("Malformed course data block");
+    }
+
+private:
+    const uchar* m_pos;
+    const uchar* m_end;
+};
+
+/**
+ * @brief Общая часть кодирования темы; варианты записываются переданной функцией.
+ */
+template <typename WriteVariant>
+QByteArray encodeBody(const Topic& topic, WriteVariant writeVariant) {
+    QByteArray buffer;
+    buffer.reserve(topic.htmlContent.size() + 64 * (topic.questions.size() + 1));
+
+    Writer writer(buffer);
+    writer.writeString(topic.htmlContent);
+    writer.writeVarint(static_cast<quint64>(topic.questions.size()));
+    for (const Question& question : topic.questions) {
+        writer.writeString(question.text);
+        writer.writeVarint(static_cast<quint64>(question.variants.size()));
+        for (const QString& variant : question.variants) {
+            writeVariant(writer, variant);
+        }
+        writer.writeSignedVarint(question.correctIndex);
+    }
+    return buffer;
+}
+
+/**
+ * @brief Общая часть декодирования темы; варианты читаются переданной функцией.
+ */
+template <typename ReadVariant>
+void decodeBody(const QByteArray& data, Topic& topic, ValidationReport* report, ReadVariant readVariant) {
+    Reader reader(data);
+
+    QString htmlContent = reader.readString();
+
+    const int questionCount = reader.readCount();
+    QList<Question> questions;
+    questions.reserve(questionCount);
+    for (int i = 0; i < questionCount; ++i) {
+        Question question;
+        question.text = reader.readString();
+
+        const int variantCount = reader.readCount();
+        question.variants.reserve(variantCount);
+        for (int j = 0; j < variantCount; ++j) {
+            question.variants.append(readVariant(reader));
+        }
+        question.correctIndex = static_cast<qint32>(reader.readSignedVarint());
+
+        // Критическая валидация после десериализации
+        const Question::Validity validity = question.sanitize();
+        if (report) {
+            report->record(validity);
+        }
+        questions.append(question);
+    }
+
+    if (!reader.atEnd()) {
+        Reader::fail();
+    }
+
+    topic.htmlContent = htmlContent;
+    topic.questions = questions;
+}
+
+/**
+ * @brief Декодирование темы в арену; варианты читаются переданной функцией.
+ */
+template <typename ReadVariant>
+void decodeViewBody(const QByteArray& data, CourseArena& arena, TopicView& topic, ValidationReport* report,
+                    ReadVariant readVariant) {
+    Reader reader(data);
+
+    const QStringView htmlContent = reader.readStringView(arena);
+
+    const int questionCount = reader.readCount();
+    QuestionView* questions = arena.allocateArray<QuestionView>(questionCount);
+    for (int i = 0; i < questionCount; ++i) {
+        QuestionView& question = questions[i];
+        question.text = reader.readStringView(arena);
+
+        const int variantCount = reader.readCount();
+        QStringView* variants = arena.allocateArray<QStringView>(variantCount);
+        for (int j = 0; j < variantCount; ++j) {
+            variants[j] = readVariant(reader);
+        }
+        question.variants = ArenaSpan<QStringView>(variants, variantCount);
+        question.correctIndex = static_cast<qint32>(reader.readSignedVarint());
+
+        const Question::Validity validity = question.sanitize();
+        if (report) {
+            report->record(validity);
+        }
+    }
+
+    if (!reader.atEnd()) {
+        Reader::fail();
+    }
+
+    topic.htmlContent = htmlContent;
+    topic.questions = ArenaSpan<QuestionView>(questions, questionCount);
+}
+
+} // namespace
+
+// ==================== StringPool ====================
+
+StringPool::StringPool(const QStringList& strings) : m_strings(strings) {
+    m_indexes.reserve(strings.size());
+    for (int i = 0; i < strings.size(); ++i) {
+        m_indexes.insert(strings[i], i);
+    }
+}
+
+int StringPool::intern(const QString& value) {
+    const auto it = m_indexes.constFind(value);
+    if (it != m_indexes.constEnd()) {
+        return it.value();
+    }
+
+    const int index = m_strings.size();
+    m_strings.append(value);
+    m_indexes.insert(value, index);
+    return index;
+}
+
+// ==================== CourseCodec ====================
+
+QByteArray CourseCodec::encodeTopicBody(const Topic& topic) {
+    return encodeBody(topic, [](Writer& writer, const QString& variant) {
+        writer.writeString(variant);
+    });
+}
+
+void CourseCodec::decodeTopicBody(const QByteArray& data, Topic& topic, ValidationReport* report) {
+    decodeBody(data, topic, report, [](Reader& reader) {
+        return reader.readString();
+    });
+}
+
+QByteArray CourseCodec::encodePooledTopicBody(const Topic& topic, StringPool& pool) {
+    return encodeBody(topic, [&pool](Writer& writer, const QString& variant) {
+        writer.writeVarint(static_cast<quint64>(pool.intern(variant)));
+    });
+}
+
+void CourseCodec::decodePooledTopicBody(const QByteArray& data, const QStringList& pool, Topic& topic,
+                                        ValidationReport* report) {
+    decodeBody(data, topic, report, [&pool](Reader& reader) {
+        const quint64 index = reader.readVarint();
+        if (index >= static_cast<quint64>(pool.size())) {
+            Reader::fail();
+        }
+        // Копия строки пула разделяет с ней данные — без новой аллокации
+        return pool[static_cast<int>(index)];
+    });
+}
+
+QVector<quint32> CourseCodec::pooledIndexes(const QByteArray& data) {
+    Reader reader(data);
+    reader.skipString();
+
+    QVector<quint32> indexes;
+    const int questionCount = reader.readCount();
+    for (int i = 0; i < questionCount; ++i) {
+        reader.skipString();
+        const int variantCount = reader.readCount();
+        for (int j = 0; j < variantCount; ++j) {
+            indexes.append(static_cast<quint32>(reader.readVarint()));
+        }
+        reader.readSignedVarint();
+    }
+
+    if (!reader.atEnd()) {
+        Reader::fail();
+    }
+    return indexes;
+}
+
+void CourseCodec::decodeTopicView(const QByteArray& data, CourseArena& arena, TopicView& topic,
+                                  ValidationReport* report) {
+    decodeViewBody(data, arena, topic, report, [&arena](Reader& reader) {
+        return reader.readStringView(arena);
+    });
+}
+
+void CourseCodec::decodePooledTopicView(const QByteArray& data, const ArenaSpan<QStringView>& pool,
+                                        CourseArena& arena, TopicView& topic, ValidationReport* report) {
+    decodeViewBody(data, arena, topic, report, [&pool](Reader& reader) {
+        const quint64 index = reader.readVarint();
+        if (index >= static_cast<quint64>(pool.size())) {
+            Reader::fail();
+        }
+        // Все вхождения варианта указывают на одну строку пула
+        return pool[static_cast<int>(index)];
+    });
+}
+
+QByteArray CourseCodec::encodeStringList(const QStringList& strings) {
+    QByteArray buffer;
+    Writer writer(buffer);
+    writer.writeVarint(static_cast<quint64>(strings.size()));
+    for (const QString& value : strings) {
+        writer.writeString(value);
+    }
+    return buffer;
+}
+
+QStringList CourseCodec::decodeStringList(const QByteArray& data) {
+    Reader reader(data);
+
+    const int count = reader.readCount();
+    QStringList strings;
+    strings.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        strings.append(reader.readString());
+    }
+
+    if (!reader.atEnd()) {
+        Reader::fail();
+    }
+    return strings;
+}
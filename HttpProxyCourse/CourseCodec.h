@@ -0,0 +1,149 @@
+#pragma once
+
+#include "DomainTypes.h"
+#include "CourseArena.h"
+#include <QByteArray>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @brief Пул уникальных строк (интернирование вариантов ответов).
+ *
+ * Каждая строка хранится один раз; блоки тем ссылаются на нее по индексу.
+ * Строки, полученные из пула, разделяют данные (implicit sharing),
+ * поэтому повторяющиеся варианты не занимают отдельной памяти.
+ */
+class StringPool {
+public:
+    StringPool() = default;
+
+    /**
+     * @brief Создает пул с уже существующими строками (индексы сохраняются).
+     * @param strings Строки пула в порядке индексов.
+     */
+    explicit StringPool(const QStringList& strings);
+
+    /**
+     * @brief Возвращает индекс строки, добавляя ее в пул при необходимости.
+     */
+    int intern(const QString& value);
+
+    /**
+     * @brief Возвращает все строки пула в порядке индексов.
+     */
+    const QStringList& strings() const { return m_strings; }
+
+    /**
+     * @brief Возвращает количество строк в пуле.
+     */
+    int size() const { return m_strings.size(); }
+
+private:
+    QHash<QString, int> m_indexes;  ///< Строка -> индекс
+    QStringList m_strings;          ///< Строки в порядке индексов
+};
+
+/**
+ * @brief Компактный бинарный кодек данных курса.
+ *
+ * Заменяет QDataStream для блоков контейнера course.dat:
+ * строки хранятся в UTF-8 с длиной в формате varint (LEB128),
+ * целые числа — varint (знаковые — в zigzag-кодировании).
+ * Декодирование идет одним проходом по непрерывному буферу
+ * (обычно по отображенной в память области файла) без промежуточных копий.
+ *
+ * Формат тела темы:
+ * @code
+ * html: string
+ * questionCount: varint
+ * question[questionCount]:
+ *     text: string
+ *     variantCount: varint
+ *     variants: string[variantCount]   (в пуловом варианте — varint-индексы StringPool)
+ *     correctIndex: zigzag varint
+ * @endcode
+ */
+class CourseCodec {
+public:
+    /**
+     * @brief Кодирует теорию и вопросы темы.
+     * @param topic Тема с загруженными теорией и вопросами.
+     * @return Закодированный блок.
+     */
+    static QByteArray encodeTopicBody(const Topic& topic);
+
+    /**
+     * @brief Декодирует теорию и вопросы темы.
+     * @param data Закодированный блок.
+     * @param topic Тема для заполнения; заголовок не изменяется.
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если блок поврежден.
+     */
+    static void decodeTopicBody(const QByteArray& data, Topic& topic, ValidationReport* report = nullptr);
+
+    /**
+     * @brief Кодирует тему, заменяя варианты ответов индексами пула строк.
+     * @param topic Тема с загруженными теорией и вопросами.
+     * @param pool Пул строк; новые варианты добавляются в него.
+     * @return Закодированный блок.
+     */
+    static QByteArray encodePooledTopicBody(const Topic& topic, StringPool& pool);
+
+    /**
+     * @brief Декодирует тему, варианты ответов которой заданы индексами пула.
+     * @param data Закодированный блок.
+     * @param pool Строки пула; варианты разделяют с ними данные.
+     * @param topic Тема для заполнения; заголовок не изменяется.
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если блок поврежден или индекс вне пула.
+     */
+    static void decodePooledTopicBody(const QByteArray& data, const QStringList& pool, Topic& topic,
+                                      ValidationReport* report = nullptr);
+
+    /**
+     * @brief Возвращает индексы пула, на которые ссылается тема, не декодируя строки.
+     * @param data Закодированный блок с вариантами ответов в виде индексов пула.
+     * @return Индексы вариантов в порядке следования (с повторами).
+     * @throws std::runtime_error Если блок поврежден.
+     */
+    static QVector<quint32> pooledIndexes(const QByteArray& data);
+
+    /**
+     * @brief Декодирует теорию и вопросы темы в арену.
+     * @param data Закодированный блок.
+     * @param arena Арена для строк и массивов темы.
+     * @param topic Тема для заполнения; заголовок не изменяется.
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если блок поврежден.
+     */
+    static void decodeTopicView(const QByteArray& data, CourseArena& arena, TopicView& topic,
+                                ValidationReport* report = nullptr);
+
+    /**
+     * @brief Декодирует в арену тему, варианты ответов которой заданы индексами пула.
+     * @param data Закодированный блок.
+     * @param pool Пул строк, уже размещенный в той же арене.
+     * @param arena Арена для строк и массивов темы.
+     * @param topic Тема для заполнения; заголовок не изменяется.
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если блок поврежден или индекс вне пула.
+     */
+    static void decodePooledTopicView(const QByteArray& data, const ArenaSpan<QStringView>& pool,
+                                      CourseArena& arena, TopicView& topic, ValidationReport* report = nullptr);
+
+    /**
+     * @brief Кодирует список строк (названия тем, пул строк).
+     * @param strings Список строк.
+     * @return Закодированный блок.
+     */
+    static QByteArray encodeStringList(const QStringList& strings);
+
+    /**
+     * @brief Декодирует список строк.
+     * @param data Закодированный блок.
+     * @return Список строк.
+     * @throws std::runtime_error Если блок поврежден.
+     */
+    static QStringList decodeStringList(const QByteArray& data);
+};
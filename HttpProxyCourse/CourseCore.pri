@@ -0,0 +1,32 @@
+# Ядро формата курса: сериализация, контейнер course.dat и конвертер JSON.
+# Зависит только от QtCore и QtConcurrent, поэтому подключается и в GUI-приложение,
+# и в консольный компилятор курсов (tools/coursec).
+
+QT += core concurrent
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/CourseArena.cpp \
+    $$PWD/CourseCodec.cpp \
+    $$PWD/CourseDataConverter.cpp \
+    $$PWD/CourseSnapshot.cpp \
+    $$PWD/CourseStorage.cpp \
+    $$PWD/Crc32c.cpp \
+    $$PWD/DefaultCourse.cpp \
+    $$PWD/HtmlMinifier.cpp \
+    $$PWD/JsonStreamReader.cpp \
+    $$PWD/Serializer.cpp
+
+HEADERS += \
+    $$PWD/CourseArena.h \
+    $$PWD/CourseCodec.h \
+    $$PWD/CourseDataConverter.h \
+    $$PWD/CourseSnapshot.h \
+    $$PWD/CourseStorage.h \
+    $$PWD/Crc32c.h \
+    $$PWD/DefaultCourse.h \
+    $$PWD/DomainTypes.h \
+    $$PWD/HtmlMinifier.h \
+    $$PWD/JsonStreamReader.h \
+    $$PWD/Serializer.h
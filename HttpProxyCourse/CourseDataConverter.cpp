@@ -1,80 +1,561 @@
 #include "CourseDataConverter.h"
-#include "Serializer.h"
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include "CourseStorage.h"
+#include "Crc32c.h"
+#include "HtmlMinifier.h"
+#include "JsonStreamReader.h"
+#include <QBitArray>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QThread>
+#include <QtConcurrent>
 #include <QDebug>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+using Token = JsonStreamReader::Token;
+
+/// @brief Сигнатура файла манифеста ("HPCM").
+constexpr quint32 ManifestMagic = 0x4850434D;
+
+/// @brief Версия формата манифеста; увеличивается, когда меняется обработка тем при сборке,
+///        чтобы блоки прежних сборок не переиспользовались.
+constexpr quint16 ManifestVersion = 3;
+
+/// @brief Количество тем в пакете на один поток.
+constexpr int TopicsPerThread = 4;
+
+/// @brief Предельный объем исходного JSON тем одного пакета в байтах.
+constexpr qint64 MaxBatchBytes = 64 * 1024 * 1024;
+
+/// @brief Доля неиспользуемых строк унаследованного пула, после которой пул собирается заново.
+constexpr double MaxDeadPoolShare = 0.5;
+
+/// @brief Меньший пул не пересобирается: мертвые строки в нем почти ничего не стоят.
+constexpr int MinPoolCompactionStrings = 256;
+
+/// @brief Каталог ресурсов рядом с JSON курса, упаковываемый в контейнер.
+const char* const AssetsDirectory = "assets";
+
+/**
+ * @brief Запись манифеста: какой JSON дал какой блок темы.
+ */
+struct ManifestEntry {
+    QByteArray jsonHash;         ///< SHA-1 исходного JSON темы
+    quint32 blockChecksum = 0;   ///< CRC32C записанного блока темы
+    QVector<quint32> poolIndexes;  ///< Индексы пула строк, на которые ссылается блок
+};
+
+/**
+ * @brief Возвращает путь к манифесту бинарного файла курса.
+ */
+QString manifestPath(const QString& binaryFilePath) {
+    return binaryFilePath + QStringLiteral(".manifest");
+}
+
+/**
+ * @brief Читает манифест; при отсутствии или повреждении возвращает пустой список.
+ */
+QVector<ManifestEntry> loadManifest(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != ManifestMagic || version != ManifestVersion) {
+        return {};
+    }
+
+    QVector<ManifestEntry> entries;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        ManifestEntry entry;
+        stream >> entry.jsonHash >> entry.blockChecksum >> entry.poolIndexes;
+        entries.append(entry);
+    }
+    return stream.status() == QDataStream::Ok ? entries : QVector<ManifestEntry>();
+}
+
+/**
+ * @brief Записывает манифест; ошибка записи только отключает инкрементальность следующей сборки.
+ */
+void saveManifest(const QString& filePath, const QVector<ManifestEntry>& entries) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write course build manifest:" << filePath;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << ManifestMagic << ManifestVersion << quint32(entries.size());
+    for (const ManifestEntry& entry : entries) {
+        stream << entry.jsonHash << entry.blockChecksum << entry.poolIndexes;
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Cannot write course build manifest:" << filePath;
+    }
+}
+
+/**
+ * @brief Читает строковое значение; значения другого типа пропускаются
+ *        и дают пустую строку (как QJsonValue::toString()).
+ */
+QString readString(JsonStreamReader& reader) {
+    switch (reader.next()) {
+    case Token::String:
+        return reader.text();
+    case Token::BeginObject:
+    case Token::BeginArray:
+        reader.skipToEnd();
+        return QString();
+    default:
+        return QString();
+    }
+}
+
+/**
+ * @brief Читает целое значение; значения другого типа, дробные и вне диапазона int
+ *        дают 0 (как QJsonValue::toInt()).
+ */
+int readInt(JsonStreamReader& reader) {
+    switch (reader.next()) {
+    case Token::Number: {
+        const double value = reader.number();
+        const bool isInt = value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()
+                           && std::floor(value) == value;
+        return isInt ? static_cast<int>(value) : 0;
+    }
+    case Token::BeginObject:
+    case Token::BeginArray:
+        reader.skipToEnd();
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Читает начало массива; значение другого типа пропускается.
+ * @return true, если массив открыт и его элементы можно читать.
+ */
+bool beginArray(JsonStreamReader& reader) {
+    const Token token = reader.next();
+    if (token == Token::BeginArray) {
+        return true;
+    }
+    if (token == Token::BeginObject) {
+        reader.skipToEnd();
+    }
+    return false;
+}
+
+/**
+ * @brief Читает один вопрос; открывающая скобка объекта уже прочитана.
+ */
+Question parseQuestion(JsonStreamReader& reader) {
+    Question question;
+    while (reader.next() == Token::Name) {
+        const QString name = reader.text();
+        if (name == QLatin1String("text")) {
+            question.text = readString(reader);
+        } else if (name == QLatin1String("correctIndex")) {
+            question.correctIndex = readInt(reader);
+        } else if (name == QLatin1String("variants")) {
+            if (!beginArray(reader)) {
+                continue;
+            }
+            for (Token token = reader.next(); token != Token::EndArray; token = reader.next()) {
+                if (token == Token::String) {
+                    question.variants.append(reader.text());
+                } else {
+                    if (token == Token::BeginObject || token == Token::BeginArray) {
+                        reader.skipToEnd();
+                    }
+                    question.variants.append(QString());
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    return question;
+}
+
+/**
+ * @brief Читает одну тему; открывающая скобка объекта уже прочитана.
+ */
+Topic parseTopic(JsonStreamReader& reader) {
+    Topic topic;
+    while (reader.next() == Token::Name) {
+        const QString name = reader.text();
+        if (name == QLatin1String("title")) {
+            topic.title = readString(reader);
+        } else if (name == QLatin1String("htmlContent")) {
+            topic.htmlContent = readString(reader);
+        } else if (name == QLatin1String("questions")) {
+            if (!beginArray(reader)) {
+                continue;
+            }
+            for (Token token = reader.next(); token != Token::EndArray; token = reader.next()) {
+                if (token == Token::BeginObject) {
+                    topic.questions.append(parseQuestion(reader));
+                } else if (token == Token::BeginArray) {
+                    reader.skipToEnd();
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    return topic;
+}
+
+/**
+ * @brief Разбирает тему из ее исходного JSON (объекта целиком).
+ */
+Topic parseTopicJson(const QByteArray& json) {
+    QBuffer buffer;
+    buffer.setData(json);
+    buffer.open(QIODevice::ReadOnly);
+
+    JsonStreamReader reader(&buffer);
+    if (reader.next() != Token::BeginObject) {
+        throw std::runtime_error("Topic JSON is not an object");
+    }
+    return parseTopic(reader);
+}
+
+/**
+ * @brief Тема, ожидающая записи в контейнер.
+ */
+struct PendingTopic {
+    QByteArray jsonHash;                 ///< SHA-1 исходного JSON темы
+    QByteArray json;                     ///< Исходный JSON измененной темы
+    int previousIndex = -1;              ///< Индекс неизмененной темы в прежнем файле
+    Topic topic;                         ///< Разобранная измененная тема
+    QByteArray payload;                  ///< Несжатое тело измененной темы
+    CourseFormat::EncodedBlock block;    ///< Готовый блок темы
+    quint32 checksum = 0;                ///< CRC32C блока
+    QVector<quint32> poolIndexes;        ///< Индексы пула строк в блоке
+    QStringList unsupportedTags;         ///< Теги, удаленные из HTML темы
+    int htmlCharsSaved = 0;              ///< На сколько символов сократился HTML
+    QString error;                       ///< Ошибка разбора в рабочем потоке
+};
+
+/**
+ * @brief Инкрементальная сборка контейнера с переиспользованием блоков прежнего файла.
+ *
+ * Темы накапливаются пакетами. Для пакета измененные темы разбираются
+ * параллельно, затем последовательно кодируются со ссылками на общий пул
+ * строк, параллельно сжимаются и записываются в исходном порядке.
+ *
+ * Пул строк наследуется от прежнего файла, и строки удаленных вариантов в нем
+ * остаются. Когда их доля превышает MaxDeadPoolShare, сборка выполняется
+ * без переиспользования блоков, с новым пулом.
+ */
+class IncrementalBuild {
+public:
+    explicit IncrementalBuild(const QString& binaryFilePath)
+        : m_binaryFilePath(binaryFilePath)
+        , m_writer(binaryFilePath)
+        , m_batchLimit(qMax(1, QThread::idealThreadCount()) * TopicsPerThread)
+    {
+        openPrevious();
+    }
+
+    /**
+     * @brief Добавляет тему по ее исходному JSON.
+     */
+    void addTopic(const QByteArray& json) {
+        PendingTopic pending;
+        pending.jsonHash = QCryptographicHash::hash(json, QCryptographicHash::Sha1);
+
+        const auto it = m_previousByHash.constFind(pending.jsonHash);
+        if (it != m_previousByHash.constEnd() && reusePrevious(it.value(), pending)) {
+            ++m_reused;
+        } else {
+            pending.json = json;
+            m_batchBytes += json.size();
+        }
+
+        m_batch.append(pending);
+        ++m_topicCount;
+        if (m_batch.size() >= m_batchLimit || m_batchBytes >= MaxBatchBytes) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Дописывает оставшиеся темы, фиксирует файл и обновляет манифест.
+     */
+    void commit() {
+        flush();
+
+        // Прежний файл больше не нужен; отображенный файл в Windows заменить нельзя
+        m_previous.reset();
+        m_previousByHash.clear();
+        m_previousManifest.clear();
+        m_writer.commit();
+        saveManifest(manifestPath(m_binaryFilePath), m_manifest);
+    }
+
+    /**
+     * @brief Упаковывает файлы каталога ресурсов под именами относительно baseDir.
+     *
+     * HTML теории ссылается на ресурсы теми же относительными путями
+     * (например, "assets/proxy.png"), что и на файлы рядом с JSON.
+     */
+    void addAssets(const QDir& baseDir) {
+        const QString assetsPath = baseDir.filePath(AssetsDirectory);
+        QDirIterator it(assetsPath, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString filePath = it.next();
+            QFile file(filePath);
+            if (!file.open(QIODevice::ReadOnly)) {
+                throw std::runtime_error("Cannot open asset file: " + filePath.toStdString());
+            }
+            const QByteArray data = file.readAll();
+            m_writer.addAsset(baseDir.relativeFilePath(filePath), data);
+            ++m_assetCount;
+            m_assetBytes += data.size();
+        }
+    }
+
+    int topicCount() const { return m_topicCount; }
+    int reusedCount() const { return m_reused; }
+    int assetCount() const { return m_assetCount; }
+    qint64 assetBytes() const { return m_assetBytes; }
+    qint64 htmlCharsSaved() const { return m_htmlCharsSaved; }
+
+private:
+    /**
+     * @brief Открывает прежний файл и отбирает темы, блоки которых совпадают с манифестом.
+     */
+    void openPrevious() {
+        if (!CourseStorage::isContainer(m_binaryFilePath)) {
+            return;
+        }
+
+        try {
+            m_previous.reset(new CourseStorage(m_binaryFilePath));
+        } catch (const std::exception& e) {
+            qWarning() << "Previous course build is unusable, rebuilding all topics:" << e.what();
+            return;
+        }
+
+        // Тема, измененная после сборки (например, в панели администратора),
+        // имеет другую контрольную сумму блока и будет закодирована заново
+        m_previousManifest = loadManifest(manifestPath(m_binaryFilePath));
+        const QVector<ManifestEntry>& manifest = m_previousManifest;
+        if (manifest.size() != m_previous->topicCount()) {
+            return;
+        }
+        for (int i = 0; i < manifest.size(); ++i) {
+            if (manifest[i].blockChecksum != 0 && !m_previous->isTopicDamaged(i)
+                && m_previous->topicChecksum(i) == manifest[i].blockChecksum
+                && !m_previousByHash.contains(manifest[i].jsonHash)) {
+                m_previousByHash.insert(manifest[i].jsonHash, i);
+            }
+        }
+        if (m_previousByHash.isEmpty()) {
+            return;
+        }
+
+        // Пул, в котором больше не используется большая часть строк, не наследуется
+        const int poolSize = m_previous->stringPool().size();
+        if (poolSize >= MinPoolCompactionStrings) {
+            QBitArray live(poolSize);
+            for (const int index : qAsConst(m_previousByHash)) {
+                for (const quint32 poolIndex : manifest[index].poolIndexes) {
+                    if (poolIndex < static_cast<quint32>(poolSize)) {
+                        live.setBit(static_cast<int>(poolIndex));
+                    }
+                }
+            }
+            const double deadShare = 1.0 - double(live.count(true)) / poolSize;
+            if (deadShare > MaxDeadPoolShare) {
+                qDebug() << "String pool of the previous build is" << qRound(deadShare * 100)
+                         << "% unused, re-encoding all topics with a new pool";
+                m_previousByHash.clear();
+                return;
+            }
+        }
+
+        // Скопированные блоки ссылаются на прежний пул строк
+        m_writer.setStringPool(m_previous->stringPool());
+    }
+
+    /**
+     * @brief Берет готовый блок темы из прежнего файла.
+     * @return false, если блок не прошел проверку и тему нужно закодировать заново.
+     */
+    bool reusePrevious(int index, PendingTopic& pending) const {
+        try {
+            pending.block = m_previous->rawTopicBlock(index);
+        } catch (const std::exception&) {
+            return false;
+        }
+        pending.previousIndex = index;
+        pending.checksum = m_previous->topicChecksum(index);
+        pending.poolIndexes = m_previousManifest[index].poolIndexes;
+        return true;
+    }
+
+    /**
+     * @brief Кодирует измененные темы пакета и записывает весь пакет по порядку.
+     */
+    void flush() {
+        // 1. Разбор JSON измененных тем — независимо для каждой темы
+        QtConcurrent::blockingMap(m_batch, [](PendingTopic& pending) {
+            if (pending.previousIndex >= 0) {
+                return;
+            }
+            try {
+                pending.topic = parseTopicJson(pending.json);
+
+                // HTML приводится к подмножеству QTextBrowser один раз — при сборке
+                HtmlMinifier::Result html = HtmlMinifier::minify(pending.topic.htmlContent);
+                pending.htmlCharsSaved = pending.topic.htmlContent.size() - html.html.size();
+                pending.topic.htmlContent = html.html;
+                pending.unsupportedTags = html.unsupportedTags;
+            } catch (const std::exception& e) {
+                pending.error = QString::fromUtf8(e.what());
+            }
+            pending.json.clear();
+        });
+
+        // 2. Интернирование вариантов ответов в общий пул — строго по порядку тем
+        for (PendingTopic& pending : m_batch) {
+            if (!pending.error.isEmpty()) {
+                throw std::runtime_error("Failed to parse topic: " + pending.error.toStdString());
+            }
+            if (pending.previousIndex < 0) {
+                pending.payload = m_writer.encodeTopicPayload(pending.topic);
+            }
+        }
+
+        // 3. Сжатие и контрольные суммы — снова параллельно
+        QtConcurrent::blockingMap(m_batch, [](PendingTopic& pending) {
+            if (pending.previousIndex >= 0) {
+                return;
+            }
+            pending.block = CourseWriter::compressTopicPayload(pending.payload);
+            pending.checksum = Crc32c::compute(pending.block.data.constData(), pending.block.data.size());
+            pending.poolIndexes = CourseCodec::pooledIndexes(pending.payload);
+            pending.payload.clear();
+        });
+
+        // 4. Запись в исходном порядке
+        for (const PendingTopic& pending : m_batch) {
+            const QString& title = pending.previousIndex >= 0 ? m_previous->titles()[pending.previousIndex]
+                                                              : pending.topic.title;
+            if (!pending.unsupportedTags.isEmpty()) {
+                qWarning() << "Topic" << title << "uses tags unsupported by QTextBrowser (removed):"
+                           << pending.unsupportedTags.join(", ");
+            }
+            m_htmlCharsSaved += pending.htmlCharsSaved;
+            m_writer.addEncodedTopic(title, pending.block);
+            m_manifest.append({pending.jsonHash, pending.checksum, pending.poolIndexes});
+        }
+
+        m_batch.clear();
+        m_batchBytes = 0;
+    }
+
+    QString m_binaryFilePath;
+    QScopedPointer<CourseStorage> m_previous;   ///< Прежний файл (открыт до commit())
+    QVector<ManifestEntry> m_previousManifest;  ///< Манифест прежней сборки
+    QHash<QByteArray, int> m_previousByHash;    ///< Хеш JSON -> индекс переиспользуемой темы
+    CourseWriter m_writer;
+    QVector<PendingTopic> m_batch;
+    qint64 m_batchBytes = 0;
+    int m_batchLimit;
+    QVector<ManifestEntry> m_manifest;          ///< Манифест новой сборки
+    int m_topicCount = 0;
+    int m_reused = 0;
+    qint64 m_htmlCharsSaved = 0;                ///< Суммарное сокращение HTML перекодированных тем
+    int m_assetCount = 0;                       ///< Упакованные ресурсы
+    qint64 m_assetBytes = 0;                    ///< Объем упакованных ресурсов
+};
+
+} // namespace
 
 bool CourseDataConverter::convertJsonToBinary(const QString& jsonFilePath, const QString& binaryFilePath) {
-    // Парсим JSON файл
-    Course course = parseJsonFile(jsonFilePath);
-    
-    if (course.topics.isEmpty()) {
-        qCritical() << "Failed to parse JSON file or course is empty:" << jsonFilePath;
+    QFile file(jsonFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open JSON file:" << jsonFilePath;
         return false;
     }
-    
+
+    QElapsedTimer timer;
+    timer.start();
+
     try {
-        // Сохраняем в бинарном формате
-        Serializer::save(course, binaryFilePath);
-        qDebug() << "Successfully converted" << course.topics.size() << "topics from JSON to binary format";
+        JsonStreamReader reader(&file);
+        IncrementalBuild build(binaryFilePath);
+
+        if (reader.next() != Token::BeginObject) {
+            throw std::runtime_error("JSON root is not an object");
+        }
+
+        while (reader.next() == Token::Name) {
+            if (reader.text() != QLatin1String("topics")) {
+                reader.skipValue();
+                continue;
+            }
+            if (!beginArray(reader)) {
+                continue;
+            }
+
+            for (Token token = reader.next(); token != Token::EndArray; token = reader.next()) {
+                if (token == Token::BeginObject) {
+                    // Исходный текст темы нужен для хеша и, если тема изменилась, для разбора
+                    reader.beginCapture();
+                    reader.skipToEnd();
+                    build.addTopic(QByteArray("{") + reader.endCapture());
+                } else if (token == Token::BeginArray) {
+                    reader.skipToEnd();
+                }
+            }
+        }
+        if (reader.next() != Token::EndOfDocument) {
+            throw std::runtime_error("Unexpected data after JSON root object");
+        }
+
+        // Без commit() временный файл QSaveFile отбрасывается, прежний файл курса сохраняется
+        if (build.topicCount() == 0) {
+            qCritical() << "Failed to parse JSON file or course is empty:" << jsonFilePath;
+            return false;
+        }
+
+        build.addAssets(QFileInfo(jsonFilePath).absoluteDir());
+        build.commit();
+        qDebug() << "Successfully converted" << build.topicCount() << "topics from JSON to binary format"
+                 << "(" << build.reusedCount() << "reused," << build.topicCount() - build.reusedCount()
+                 << "re-encoded, HTML reduced by" << build.htmlCharsSaved() << "characters,"
+                 << build.assetCount() << "assets," << build.assetBytes() << "bytes,"
+                 << timer.elapsed() << "ms)";
         return true;
     } catch (const std::exception& e) {
-        qCritical() << "Failed to save binary file:" << e.what();
+        qCritical() << "Failed to convert" << jsonFilePath << ":" << e.what();
         return false;
     }
 }
-
-Course CourseDataConverter::parseJsonFile(const QString& jsonFilePath) {
-    Course course;
-    
-    QFile file(jsonFilePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qCritical() << "Cannot open JSON file:" << jsonFilePath;
-        return course;
-    }
-    
-    QByteArray jsonData = file.readAll();
-    file.close();
-    
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
-    
-    if (parseError.error != QJsonParseError::NoError) {
-        qCritical() << "JSON parse error:" << parseError.errorString();
-        return course;
-    }
-    
-    QJsonObject rootObj = doc.object();
-    QJsonArray topicsArray = rootObj["topics"].toArray();
-    
-    for (const QJsonValue& topicValue : topicsArray) {
-        QJsonObject topicObj = topicValue.toObject();
-        
-        Topic topic;
-        topic.title = topicObj["title"].toString();
-        topic.htmlContent = topicObj["htmlContent"].toString();
-        
-        QJsonArray questionsArray = topicObj["questions"].toArray();
-        for (const QJsonValue& questionValue : questionsArray) {
-            QJsonObject questionObj = questionValue.toObject();
-            
-            Question question;
-            question.text = questionObj["text"].toString();
-            question.correctIndex = questionObj["correctIndex"].toInt();
-            
-            QJsonArray variantsArray = questionObj["variants"].toArray();
-            for (const QJsonValue& variantValue : variantsArray) {
-                question.variants.append(variantValue.toString());
-            }
-            
-            topic.questions.append(question);
-        }
-        
-        course.topics.append(topic);
-    }
-    
-    qDebug() << "Parsed" << course.topics.size() << "topics from JSON";
-    return course;
-}
\ No newline at end of file
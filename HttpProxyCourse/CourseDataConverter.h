@@ -6,8 +6,22 @@
 /**
  * @brief Утилита для конвертации данных курса из JSON в бинарный формат.
  * 
- * Этот класс используется для одноразовой конвертации существующих JSON данных
- * в требуемый бинарный формат с использованием QDataStream.
+ * JSON читается потоково (JsonStreamReader), темы передаются в CourseWriter
+ * пакетами, поэтому документ целиком в память не загружается.
+ *
+ * Сборка инкрементальная: рядом с бинарным файлом хранится манифест
+ * (<файл>.manifest) с хешем исходного JSON каждой темы. Темы, JSON которых
+ * не изменился, копируются из прежнего файла готовыми блоками; измененные
+ * разбираются и сжимаются параллельно на всех ядрах. Манифест хранит и индексы
+ * пула строк каждой темы: когда большая часть унаследованного пула не
+ * используется, курс собирается заново с новым пулом.
+ *
+ * HTML теории при сборке нормализуется HtmlMinifier: удаляются комментарии,
+ * лишние пробелы и разметка, не поддерживаемая QTextBrowser.
+ *
+ * Файлы каталога assets/ рядом с JSON (схемы, иллюстрации) упаковываются
+ * в контейнер как ресурсы; HTML ссылается на них относительными путями,
+ * например &lt;img src="assets/proxy.png"&gt;.
  */
 class CourseDataConverter {
 public:
@@ -18,12 +32,4 @@ public:
      * @return true, если конвертация прошла успешно.
      */
     static bool convertJsonToBinary(const QString& jsonFilePath, const QString& binaryFilePath);
-
-private:
-    /**
-     * @brief Парсит JSON и создает объект Course.
-     * @param jsonFilePath Путь к JSON файлу.
-     * @return Объект Course или пустой объект при ошибке.
-     */
-    static Course parseJsonFile(const QString& jsonFilePath);
-};
\ No newline at end of file
+};
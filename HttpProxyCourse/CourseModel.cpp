@@ -7,13 +7,16 @@
 
 // ==================== CourseModel ====================
 
-CourseModel::CourseModel(QObject* parent) : QObject(parent) {
-    // Инициализация модели
+CourseModel::CourseModel(QObject* parent)
+    : QObject(parent)
+    , m_course(SharedCoursePtr::create(Course()))
+{
 }
 
 bool CourseModel::loadCourse(const QString& filePath) {
     try {
-        m_course = Serializer::load(filePath);
+        m_course = SharedCourse::loadOrDefault(filePath);
+        SharedCourse::preloadInBackground(m_course);
         emit courseDataChanged();
         return true;
     } catch (const std::exception& e) {
@@ -26,7 +29,7 @@ bool CourseModel::loadCourse(const QString& filePath) {
 
 bool CourseModel::saveCourse(const QString& filePath) {
     try {
-        Serializer::save(m_course, filePath);
+        Serializer::save(m_course->toCourse(), filePath);
         return true;
     } catch (const std::exception& e) {
         QString errorMsg = QString("Ошибка сохранения курса: %1").arg(e.what());
@@ -36,50 +39,105 @@ bool CourseModel::saveCourse(const QString& filePath) {
     }
 }
 
+void CourseModel::setCourse(const SharedCoursePtr& course) {
+    if (!course || course == m_course) {
+        return;
+    }
+
+    const SharedCoursePtr previous = m_course;
+    m_course = course;
+    QVector<int> changed;
+    if (previous->topicCount() == course->topicCount()) {
+        for (int i = 0; i < course->topicCount(); ++i) {
+            if (!course->sharesTopic(*previous, i)) {
+                changed.append(i);
+            }
+        }
+    }
+
+    // Снимок получен правкой, если неизмененные темы разделяются; иначе это другой курс
+    if (changed.isEmpty() || changed.size() == course->topicCount()) {
+        emit courseDataChanged();
+        return;
+    }
+    for (int i : changed) {
+        emit topicChanged(i, changedFields(*previous, *course, i));
+    }
+}
+
 int CourseModel::getTopicCount() const {
-    return m_course.topics.size();
+    return m_course->topicCount();
 }
 
-const Topic* CourseModel::getTopic(int index) const {
-    if (index < 0 || index >= m_course.topics.size()) {
+TopicPtr CourseModel::getTopic(int index) const {
+    if (index < 0 || index >= m_course->topicCount()) {
+        return nullptr;
+    }
+
+    // Теория и вопросы подгружаются из файла курса при первом обращении
+    try {
+        return m_course->topic(index);
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to load topic" << index << ":" << e.what();
         return nullptr;
     }
-    return &m_course.topics[index];
 }
 
 void CourseModel::addTopic(const Topic& topic) {
-    m_course.topics.append(topic);
-    emit courseDataChanged();
+    m_course = m_course->withAppendedTopic(topic);
+    emit topicInserted(m_course->topicCount() - 1);
 }
 
 bool CourseModel::updateTopic(int index, const Topic& topic) {
-    if (index < 0 || index >= m_course.topics.size()) {
+    if (index < 0 || index >= m_course->topicCount()) {
         return false;
     }
-    m_course.topics[index] = topic;
-    emit courseDataChanged();
+    const SharedCoursePtr previous = m_course;
+    m_course = m_course->withTopic(index, topic);
+    const TopicFields fields = changedFields(*previous, *m_course, index);
+    if (fields) {
+        emit topicChanged(index, fields);
+    }
     return true;
 }
 
 bool CourseModel::removeTopic(int index) {
-    if (index < 0 || index >= m_course.topics.size()) {
+    if (index < 0 || index >= m_course->topicCount()) {
         return false;
     }
-    m_course.topics.removeAt(index);
-    emit courseDataChanged();
+    m_course = m_course->withoutTopic(index);
+    emit topicRemoved(index);
     return true;
 }
 
 QStringList CourseModel::getTopicTitles() const {
-    QStringList titles;
-    for (const Topic& topic : m_course.topics) {
-        titles << topic.title;
-    }
-    return titles;
+    return m_course->topicTitles();
+}
+
+SharedCoursePtr CourseModel::getCourse() const {
+    return m_course;
 }
 
-const QList<Topic>& CourseModel::getTopics() const {
-    return m_course.topics;
+CourseModel::TopicFields CourseModel::changedFields(const SharedCourse& before, const SharedCourse& after,
+                                                    int index) {
+    TopicFields fields;
+    if (before.topicTitle(index) != after.topicTitle(index)) {
+        fields |= TitleField;
+    }
+
+    // Незагруженное тело не читается из файла ради сравнения
+    const TopicPtr oldTopic = before.loadedTopic(index);
+    const TopicPtr newTopic = after.loadedTopic(index);
+    if (!oldTopic || !newTopic) {
+        return fields | ContentField | QuestionsField;
+    }
+    if (oldTopic->htmlContent != newTopic->htmlContent) {
+        fields |= ContentField;
+    }
+    if (oldTopic->questions != newTopic->questions) {
+        fields |= QuestionsField;
+    }
+    return fields;
 }
 
 // ==================== TestResultsModel ====================
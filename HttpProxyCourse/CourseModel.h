@@ -5,17 +5,34 @@
 #include <QSqlQueryModel>
 #include <QSortFilterProxyModel>
 #include "DomainTypes.h"
+#include "SharedCourse.h"
 
 /**
  * @brief Модель данных курса (Model в архитектуре MVC).
  * 
  * Отвечает за загрузку, хранение и управление данными курса.
  * Обеспечивает доступ к темам, вопросам и прогрессу студентов.
+ *
+ * Правка одной темы сообщается сигналами topicInserted(), topicRemoved()
+ * и topicChanged() с маской измененных полей, чтобы представления обновляли
+ * одну строку. courseDataChanged() означает замену курса целиком.
  */
 class CourseModel : public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Поля темы, изменение которых сообщает topicChanged().
+     */
+    enum TopicField {
+        TitleField = 0x1,      ///< Название
+        ContentField = 0x2,    ///< HTML теории
+        QuestionsField = 0x4,  ///< Вопросы теста
+        AllTopicFields = TitleField | ContentField | QuestionsField
+    };
+    Q_DECLARE_FLAGS(TopicFields, TopicField)
+    Q_FLAG(TopicFields)
+
     /**
      * @brief Конструктор модели курса.
      * @param parent Родительский объект для управления памятью.
@@ -36,6 +53,17 @@ public:
      */
     bool saveCourse(const QString& filePath);
 
+    /**
+     * @brief Заменяет текущий снимок курса (например, созданный панелью администратора).
+     *
+     * Если количество тем не изменилось и часть тем разделяется с прежним
+     * снимком, для каждой измененной темы выдается topicChanged() (темы при
+     * этом не загружаются); иначе — courseDataChanged().
+     *
+     * @param course Новый снимок курса.
+     */
+    void setCourse(const SharedCoursePtr& course);
+
     /**
      * @brief Получить количество тем в курсе.
      * @return Количество тем.
@@ -44,19 +72,20 @@ public:
 
     /**
      * @brief Получить тему по индексу.
+     * Теория и вопросы темы подгружаются из файла курса при первом обращении.
      * @param index Индекс темы (0-based).
-     * @return Указатель на тему или nullptr, если индекс неверный.
+     * @return Тема из общего снимка курса или nullptr, если индекс неверный или тема повреждена.
      */
-    const Topic* getTopic(int index) const;
+    TopicPtr getTopic(int index) const;
 
     /**
-     * @brief Добавить новую тему в курс.
+     * @brief Добавить новую тему в курс (создается новый снимок курса).
      * @param topic Тема для добавления.
      */
     void addTopic(const Topic& topic);
 
     /**
-     * @brief Обновить существующую тему.
+     * @brief Обновить существующую тему (создается новый снимок курса).
      * @param index Индекс темы для обновления.
      * @param topic Новые данные темы.
      * @return true, если обновление прошло успешно.
@@ -64,7 +93,7 @@ public:
     bool updateTopic(int index, const Topic& topic);
 
     /**
-     * @brief Удалить тему по индексу.
+     * @brief Удалить тему по индексу (создается новый снимок курса).
      * @param index Индекс темы для удаления.
      * @return true, если удаление прошло успешно.
      */
@@ -77,17 +106,36 @@ public:
     QStringList getTopicTitles() const;
 
     /**
-     * @brief Получить все темы курса.
-     * @return Список всех тем.
+     * @brief Получить текущий снимок курса для совместного использования.
+     * @return Неизменяемый снимок курса.
      */
-    const QList<Topic>& getTopics() const;
+    SharedCoursePtr getCourse() const;
 
 signals:
     /**
-     * @brief Сигнал об изменении данных курса.
+     * @brief Сигнал о замене курса целиком (загрузка файла, изменение состава тем).
      */
     void courseDataChanged();
 
+    /**
+     * @brief Сигнал о добавлении темы.
+     * @param index Индекс новой темы; индексы последующих тем увеличились на 1.
+     */
+    void topicInserted(int index);
+
+    /**
+     * @brief Сигнал об удалении темы.
+     * @param index Индекс удаленной темы; индексы последующих тем уменьшились на 1.
+     */
+    void topicRemoved(int index);
+
+    /**
+     * @brief Сигнал об изменении темы.
+     * @param index Индекс темы.
+     * @param fields Измененные поля.
+     */
+    void topicChanged(int index, CourseModel::TopicFields fields);
+
     /**
      * @brief Сигнал об ошибке при работе с данными.
      * @param errorMessage Сообщение об ошибке.
@@ -95,9 +143,19 @@ signals:
     void errorOccurred(const QString& errorMessage);
 
 private:
-    Course m_course;  ///< Данные курса
+    /**
+     * @brief Определяет измененные поля темы между двумя снимками.
+     *
+     * Тела тем сравниваются, только если загружены в обоих снимках;
+     * иначе теория и вопросы считаются измененными.
+     */
+    static TopicFields changedFields(const SharedCourse& before, const SharedCourse& after, int index);
+
+    SharedCoursePtr m_course;  ///< Текущий снимок курса (тела тем подгружаются лениво)
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(CourseModel::TopicFields)
+
 /**
  * @brief Модель для работы с результатами тестов студентов.
  * 
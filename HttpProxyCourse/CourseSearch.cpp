@@ -0,0 +1,75 @@
+#include "CourseSearch.h"
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+
+CourseSearch::CourseSearch(QObject* parent)
+    : QObject(parent)
+{
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(RebuildDelayMs);
+    connect(&m_rebuildTimer, &QTimer::timeout, this, &CourseSearch::startBuild);
+    connect(&m_watcher, &QFutureWatcher<SearchIndexPtr>::finished, this, &CourseSearch::onBuildFinished);
+}
+
+void CourseSearch::setCourse(const SharedCoursePtr& course) {
+    if (!course || course == m_course) {
+        return;
+    }
+    m_course = course;
+
+    if (m_indexedCourse) {
+        m_rebuildTimer.start();
+    } else {
+        startBuild();
+    }
+}
+
+QVector<SearchHit> CourseSearch::search(const QString& query, int maxResults) const {
+    if (!m_index) {
+        return QVector<SearchHit>();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<SearchHit> hits = m_index->search(query, maxResults);
+
+    // Результаты прежнего индекса остаются, только если тема на той же позиции не менялась
+    if (m_searchedCourse != m_course) {
+        const SharedCourse& indexed = *m_searchedCourse;
+        const SharedCourse& current = *m_course;
+        hits.erase(std::remove_if(hits.begin(), hits.end(), [&](const SearchHit& hit) {
+            return hit.topicIndex >= indexed.topicCount() || hit.topicIndex >= current.topicCount()
+                || !indexed.sharesTopic(current, hit.topicIndex);
+        }), hits.end());
+    }
+
+    const qint64 elapsed = timer.elapsed();
+    if (elapsed > SearchBudgetMs) {
+        qWarning() << "Search for" << query << "took" << elapsed << "ms over"
+                   << m_index->topicCount() << "topics," << m_index->termCount() << "terms";
+    } else {
+        qDebug() << "Search for" << query << "took" << elapsed << "ms," << hits.size() << "hits";
+    }
+    return hits;
+}
+
+void CourseSearch::startBuild() {
+    // Текущее построение не прерывается: по его окончании индекс перестроится для нового курса
+    if (m_watcher.isRunning() || !m_course || m_course == m_indexedCourse) {
+        return;
+    }
+    m_indexedCourse = m_course;
+    m_watcher.setFuture(QtConcurrent::run(&SearchIndex::build, m_indexedCourse));
+}
+
+void CourseSearch::onBuildFinished() {
+    m_index = m_watcher.result();
+    m_searchedCourse = m_indexedCourse;
+    emit indexReady();
+
+    if (m_course != m_indexedCourse && !m_rebuildTimer.isActive()) {
+        startBuild();
+    }
+}
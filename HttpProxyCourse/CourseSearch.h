@@ -0,0 +1,86 @@
+#pragma once
+
+#include "SearchIndex.h"
+#include "SharedCourse.h"
+#include <QFutureWatcher>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief Полнотекстовый поиск по текущему курсу.
+ *
+ * Индекс строится в фоновом потоке при загрузке курса и перестраивается
+ * после правок (с задержкой, чтобы серия правок давала одно построение).
+ * Пока строится новый индекс, запросы обслуживает прежний: из его
+ * результатов остаются только темы, которые текущий снимок разделяет со
+ * снимком индекса на той же позиции (SharedCourse::sharesTopic()), поэтому
+ * после вставки, удаления или правки темы результат не откроет другую тему.
+ *
+ * Используется из главного потока.
+ */
+class CourseSearch : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Задержка перестроения индекса после правки курса (в мс).
+    static constexpr int RebuildDelayMs = 500;
+
+    /// @brief Целевое время ответа на запрос (в мс); более медленные запросы попадают в журнал.
+    static constexpr int SearchBudgetMs = 10;
+
+    /**
+     * @brief Конструктор.
+     * @param parent Родительский объект.
+     */
+    explicit CourseSearch(QObject* parent = nullptr);
+
+    /**
+     * @brief Задает курс; индекс первого курса строится сразу, после правок — с задержкой.
+     * @param course Снимок курса.
+     */
+    void setCourse(const SharedCoursePtr& course);
+
+    /**
+     * @brief Проверяет, построен ли хотя бы один индекс.
+     */
+    bool isReady() const { return !m_index.isNull(); }
+
+    /**
+     * @brief Ищет темы по запросу.
+     * @param query Текст запроса.
+     * @param maxResults Наибольшее число результатов.
+     * @return Результаты по релевантности, действительные для текущего курса;
+     *         пустой список, пока индекс не готов.
+     */
+    QVector<SearchHit> search(const QString& query, int maxResults = 50) const;
+
+    /**
+     * @brief Возвращает снимок курса, для которого действительны результаты search().
+     */
+    const SharedCoursePtr& course() const { return m_course; }
+
+signals:
+    /**
+     * @brief Сигнал о готовности нового индекса.
+     */
+    void indexReady();
+
+private slots:
+    /**
+     * @brief Запускает построение индекса для текущего курса.
+     */
+    void startBuild();
+
+    /**
+     * @brief Принимает построенный индекс.
+     */
+    void onBuildFinished();
+
+private:
+    SharedCoursePtr m_course;                  ///< Текущий курс
+    SharedCoursePtr m_indexedCourse;           ///< Курс, для которого строится или построен индекс
+    SearchIndexPtr m_index;                    ///< Последний построенный индекс
+    SharedCoursePtr m_searchedCourse;          ///< Курс, по которому построен m_index
+    QFutureWatcher<SearchIndexPtr> m_watcher;  ///< Фоновое построение
+    QTimer m_rebuildTimer;                     ///< Отложенное перестроение после правок
+};
@@ -0,0 +1,26 @@
+#include "CourseSnapshot.h"
+
+CourseSnapshot::CourseSnapshot(const CourseStorage& storage, const QVector<int>& indexes,
+                               ValidationReport* report) {
+    // Пул строк копируется один раз: все вхождения варианта ссылаются на него
+    const QStringList& poolStrings = storage.stringPool();
+    QStringView* pool = m_arena.allocateArray<QStringView>(poolStrings.size());
+    for (int i = 0; i < poolStrings.size(); ++i) {
+        pool[i] = m_arena.copy(poolStrings[i]);
+    }
+    const ArenaSpan<QStringView> poolView(pool, poolStrings.size());
+
+    TopicView* topics = m_arena.allocateArray<TopicView>(indexes.size());
+    for (int i = 0; i < indexes.size(); ++i) {
+        const QString& title = storage.titles()[indexes[i]];
+        topics[i].title = m_arena.copy(title);
+        try {
+            storage.readTopicView(indexes[i], poolView, m_arena, topics[i], report);
+        } catch (const std::exception& e) {
+            if (report) {
+                report->failedTopics << QString("%1: %2").arg(title, e.what());
+            }
+        }
+    }
+    m_topics = ArenaSpan<TopicView>(topics, indexes.size());
+}
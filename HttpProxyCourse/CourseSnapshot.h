@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CourseArena.h"
+#include "CourseStorage.h"
+#include <QVector>
+
+/**
+ * @brief Неизменяемый снимок тем курса, целиком размещенный в одной арене.
+ *
+ * Все строки и массивы тем лежат в CourseArena и доступны через QStringView,
+ * поэтому декодирование не создает отдельных QString/QList, а уничтожение
+ * снимка освобождает всю память одной операцией. Используется для проходов
+ * по всему курсу, после которых темы не нужны (SharedCourse::preloadAll()).
+ */
+class CourseSnapshot {
+public:
+    /**
+     * @brief Декодирует указанные темы контейнера в арену.
+     *
+     * Поврежденная тема остается пустой и попадает в ValidationReport::failedTopics.
+     *
+     * @param storage Открытый контейнер курса; после создания снимка может быть закрыт.
+     * @param indexes Индексы тем в контейнере; темы снимка следуют в том же порядке.
+     * @param report Сводка проверки вопросов и список поврежденных тем (может быть nullptr).
+     */
+    CourseSnapshot(const CourseStorage& storage, const QVector<int>& indexes, ValidationReport* report = nullptr);
+
+    CourseSnapshot(const CourseSnapshot&) = delete;
+    CourseSnapshot& operator=(const CourseSnapshot&) = delete;
+
+    /**
+     * @brief Возвращает темы снимка.
+     */
+    const ArenaSpan<TopicView>& topics() const { return m_topics; }
+
+    /**
+     * @brief Возвращает объем памяти, занятой снимком, в байтах.
+     */
+    std::size_t memoryUsage() const { return m_arena.bytesAllocated(); }
+
+private:
+    CourseArena m_arena;             ///< Память всех строк и массивов снимка
+    ArenaSpan<TopicView> m_topics;   ///< Темы снимка
+};
@@ -0,0 +1,857 @@
+#include "CourseStorage.h"
+#include "CourseCodec.h"
+#include "Crc32c.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+#include <limits>
+#include <stdexcept>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Заголовок контейнера в разобранном виде.
+ */
+struct Header {
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 flags = 0;
+    quint32 topicCount = 0;
+    quint32 assetsSize = 0;   ///< Размер каталога ресурсов (FlagAssets), ранее зарезервированное поле
+    quint64 tableOffset = 0;
+    quint64 titlesOffset = 0;
+    quint64 titlesSize = 0;
+    quint64 poolOffset = 0;
+    quint64 poolSize = 0;   ///< 0 — пул строк отсутствует (файлы без интернирования)
+    quint32 indexChecksum = 0;   ///< CRC32C блоков названий, пула и каталога ресурсов (v3)
+
+    /// @brief Смещение каталога ресурсов: он следует сразу за пулом строк.
+    quint64 assetsOffset() const { return poolOffset + poolSize; }
+};
+
+/**
+ * @brief Читает заголовок контейнера из потока.
+ */
+Header readHeader(QDataStream& stream) {
+    Header header;
+    stream >> header.magic >> header.version >> header.flags >> header.topicCount
+           >> header.assetsSize >> header.tableOffset >> header.titlesOffset >> header.titlesSize
+           >> header.poolOffset >> header.poolSize >> header.indexChecksum;
+    return header;
+}
+
+/**
+ * @brief Проверяет контрольную сумму заголовка v3.
+ * @param bytes Заголовок целиком (HeaderSize байт).
+ */
+bool isHeaderIntact(const char* bytes) {
+    const uchar* checksum = reinterpret_cast<const uchar*>(bytes) + CourseFormat::HeaderChecksumOffset;
+    return Crc32c::compute(bytes, CourseFormat::HeaderChecksumOffset) == qFromBigEndian<quint32>(checksum);
+}
+
+/**
+ * @brief Возвращает размер записи таблицы смещений для версии формата.
+ */
+int tableEntrySize(quint16 version) {
+    return version == CourseFormat::LegacyVersion ? CourseFormat::LegacyTableEntrySize
+                                                  : CourseFormat::TableEntrySize;
+}
+
+/// @brief Уровень сжатия zlib для блоков тем.
+constexpr int CompressionLevel = 6;
+
+/**
+ * @brief Сжимает закодированное тело темы в независимый блок контейнера.
+ * @param payload Несжатое тело темы.
+ * @param encoding Несжатый способ кодирования (Compact или Pooled).
+ */
+CourseFormat::EncodedBlock compressTopicBody(const QByteArray& payload, quint8 encoding) {
+    CourseFormat::EncodedBlock block;
+    block.data = qCompress(payload, CompressionLevel);
+    block.encoding = static_cast<quint8>(encoding + 1);  // Compact -> CompactZlib, Pooled -> PooledZlib
+
+    // Очень короткие темы zlib может только увеличить
+    if (block.data.size() >= payload.size()) {
+        block.data = payload;
+        block.encoding = encoding;
+    }
+    return block;
+}
+
+/**
+ * @brief Кодирует теорию и вопросы темы со ссылками на пул строк.
+ * @param pool Пул строк; новые варианты ответов добавляются в него.
+ */
+CourseFormat::EncodedBlock encodeTopicBody(const Topic& topic, StringPool& pool) {
+    return compressTopicBody(CourseCodec::encodePooledTopicBody(topic, pool), CourseFormat::Pooled);
+}
+
+/**
+ * @brief Декодирует блок названий тем с учетом флагов заголовка.
+ * @return false, если блок поврежден.
+ */
+bool decodeTitlesBlock(const QByteArray& block, quint16 flags, QStringList& titles) {
+    if (flags & CourseFormat::FlagCompactTitles) {
+        try {
+            titles = CourseCodec::decodeStringList(block);
+        } catch (const std::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    // Ранние файлы v2: QStringList в QDataStream
+    QDataStream stream(block);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream >> titles;
+    return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief Проверяет, известен ли способ кодирования блока.
+ */
+bool isKnownEncoding(quint8 encoding) {
+    return encoding <= CourseFormat::PooledZlib;
+}
+
+/**
+ * @brief Проверяет, сжат ли блок qCompress.
+ */
+bool isCompressedEncoding(quint8 encoding) {
+    return encoding == CourseFormat::DataStreamZlib || encoding == CourseFormat::CompactZlib
+           || encoding == CourseFormat::PooledZlib;
+}
+
+/// @brief Размер части записи таблицы, покрытой ее контрольной суммой.
+constexpr int TableEntryChecksummedSize = 20;
+
+/**
+ * @brief Кодирует запись таблицы смещений вместе с ее контрольной суммой.
+ */
+QByteArray encodeTableEntry(const CourseFormat::TableEntry& entry) {
+    QByteArray bytes;
+    bytes.reserve(CourseFormat::TableEntrySize);
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << entry.offset << entry.size << entry.encoding << quint8(0) << quint16(0) << entry.checksum;
+    stream << Crc32c::compute(bytes.constData(), TableEntryChecksummedSize);
+    bytes.append(CourseFormat::TableEntrySize - bytes.size(), '\0');
+    return bytes;
+}
+
+/**
+ * @brief Декодирует запись таблицы смещений.
+ * @param bytes Запись таблицы (tableEntrySize(version) байт).
+ * @param version Версия формата файла.
+ * @return false, если не совпала контрольная сумма записи (v3).
+ */
+bool decodeTableEntry(const QByteArray& bytes, quint16 version, CourseFormat::TableEntry& entry) {
+    QDataStream stream(bytes);
+    quint8 reserved8 = 0;
+    quint16 reserved16 = 0;
+    stream >> entry.offset >> entry.size >> entry.encoding >> reserved8 >> reserved16;
+    if (version == CourseFormat::LegacyVersion) {
+        return true;
+    }
+
+    quint32 entryChecksum = 0;
+    stream >> entry.checksum >> entryChecksum;
+    return Crc32c::compute(bytes.constData(), TableEntryChecksummedSize) == entryChecksum;
+}
+
+/**
+ * @brief Кодирует каталог ресурсов.
+ */
+QByteArray encodeAssetDirectory(const QVector<CourseFormat::AssetEntry>& assets) {
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << quint32(assets.size());
+    for (const CourseFormat::AssetEntry& asset : assets) {
+        stream << asset.name << asset.offset << asset.size << asset.checksum;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Декодирует каталог ресурсов.
+ * @return false, если каталог поврежден.
+ */
+bool decodeAssetDirectory(const QByteArray& bytes, QVector<CourseFormat::AssetEntry>& assets) {
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 count = 0;
+    stream >> count;
+    // Запись каталога занимает не меньше 20 байт: защита от неправдоподобного count
+    if (stream.status() != QDataStream::Ok || count > static_cast<quint32>(bytes.size()) / 20) {
+        return false;
+    }
+
+    assets.resize(static_cast<int>(count));
+    for (CourseFormat::AssetEntry& asset : assets) {
+        stream >> asset.name >> asset.offset >> asset.size >> asset.checksum;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief Сбрасывает буферы файла на диск (fsync).
+ */
+bool syncToDisk(QFile& file) {
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return ::_commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+/**
+ * @brief Мьютекс, упорядочивающий изменения файлов курса внутри процесса.
+ */
+QMutex& journalMutex() {
+    static QMutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief Число открытых CourseStorage по абсолютному пути файла.
+ */
+QHash<QString, int>& mappedFiles() {
+    static QHash<QString, int> files;
+    return files;
+}
+
+/**
+ * @brief Мьютекс, защищающий mappedFiles().
+ */
+QMutex& mappedFilesMutex() {
+    static QMutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief Создает поток чтения поверх участка отображенной памяти без копирования.
+ */
+QByteArray rawRegion(const uchar* data, quint64 offset, quint64 size) {
+    if (size > static_cast<quint64>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Course container region is too large");
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(data + offset), static_cast<int>(size));
+}
+
+/**
+ * @brief Проверяет, что участок [offset, offset + size) лежит внутри файла.
+ *
+ * Сумма offset + size не вычисляется: в поврежденном файле она может переполниться.
+ */
+bool isInFile(quint64 offset, quint64 size, quint64 fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+/**
+ * @brief Дописывает нулевые байты в поток.
+ */
+void writeZeros(QDataStream& stream, int count) {
+    static const char zeros[CourseFormat::HeaderSize] = {};
+    while (count > 0) {
+        const int chunk = qMin(count, CourseFormat::HeaderSize);
+        stream.writeRawData(zeros, chunk);
+        count -= chunk;
+    }
+}
+
+} // namespace
+
+// ==================== CourseStorage ====================
+
+bool CourseStorage::isContainer(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    stream >> magic;
+    return stream.status() == QDataStream::Ok && magic == CourseFormat::Magic;
+}
+
+CourseStorage::CourseStorage(const QString& filePath)
+    : m_filePath(filePath)
+    , m_version(0)
+    , m_file(filePath)
+    , m_data(nullptr)
+    , m_size(0)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error("Cannot open file for reading: " + filePath.toStdString());
+    }
+
+    m_size = m_file.size();
+    if (m_size < CourseFormat::HeaderSize) {
+        throw std::runtime_error("Course container is truncated: " + filePath.toStdString());
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        throw std::runtime_error("Cannot map course container into memory: " + filePath.toStdString());
+    }
+
+    // Заголовок: сигнатура, версия и контрольная сумма проверяются до разбора остального файла
+    const QByteArray headerBlock = rawRegion(m_data, 0, CourseFormat::HeaderSize);
+    QDataStream headerStream(headerBlock);
+    const Header header = readHeader(headerStream);
+
+    if (header.magic != CourseFormat::Magic) {
+        throw std::runtime_error("Not a course container: " + filePath.toStdString());
+    }
+    if (header.version != CourseFormat::Version && header.version != CourseFormat::LegacyVersion) {
+        throw std::runtime_error("Unsupported course container version " + std::to_string(header.version)
+                                 + ": " + filePath.toStdString());
+    }
+    m_version = header.version;
+    const bool checksummed = m_version != CourseFormat::LegacyVersion;
+    if (checksummed && !isHeaderIntact(headerBlock.constData())) {
+        throw std::runtime_error("Course container header is damaged: " + filePath.toStdString());
+    }
+
+    const quint64 fileSize = static_cast<quint64>(m_size);
+    const int entrySize = tableEntrySize(m_version);
+    const quint64 tableSize = quint64(header.topicCount) * entrySize;
+    if (header.tableOffset < CourseFormat::HeaderSize || !isInFile(header.tableOffset, tableSize, fileSize)
+        || !isInFile(header.titlesOffset, header.titlesSize, fileSize)
+        || !isInFile(header.poolOffset, header.poolSize, fileSize)
+        || !isInFile(header.assetsOffset(), header.assetsSize, fileSize)) {
+        throw std::runtime_error("Course container index is out of file bounds: " + filePath.toStdString());
+    }
+
+    // Названия и пул нужны всем темам, поэтому их повреждение делает файл непригодным
+    const bool hasAssets = (header.flags & CourseFormat::FlagAssets) != 0;
+    if (checksummed) {
+        quint32 indexChecksum = Crc32c::compute(m_data + header.titlesOffset,
+                                                static_cast<qint64>(header.titlesSize));
+        indexChecksum = Crc32c::compute(m_data + header.poolOffset,
+                                        static_cast<qint64>(header.poolSize), indexChecksum);
+        if (hasAssets) {
+            indexChecksum = Crc32c::compute(m_data + header.assetsOffset(),
+                                            static_cast<qint64>(header.assetsSize), indexChecksum);
+        }
+        if (indexChecksum != header.indexChecksum) {
+            throw std::runtime_error("Course container index is damaged: " + filePath.toStdString());
+        }
+    }
+
+    // Таблица смещений: поврежденная запись выводит из строя только свою тему
+    m_entries.resize(static_cast<int>(header.topicCount));
+    m_damaged.resize(m_entries.size());
+    for (int i = 0; i < m_entries.size(); ++i) {
+        CourseFormat::TableEntry& entry = m_entries[i];
+        const QByteArray entryBytes = rawRegion(m_data, header.tableOffset + quint64(i) * entrySize, entrySize);
+        if (!decodeTableEntry(entryBytes, m_version, entry)
+            || entry.offset < CourseFormat::HeaderSize || !isInFile(entry.offset, entry.size, fileSize)
+            || !isKnownEncoding(entry.encoding)) {
+            m_damaged.setBit(i);
+        }
+    }
+    if (m_damaged.count(true) > 0) {
+        qWarning() << "Course container" << filePath << "has" << m_damaged.count(true)
+                   << "damaged topic table entries";
+    }
+
+    // Названия тем — единственные строки, декодируемые при открытии
+    const QByteArray titlesBlock = rawRegion(m_data, header.titlesOffset, header.titlesSize);
+    if (!decodeTitlesBlock(titlesBlock, header.flags, m_titles) || m_titles.size() != m_entries.size()) {
+        throw std::runtime_error("Failed to read topic titles from: " + filePath.toStdString());
+    }
+
+    // Пул строк декодируется один раз; варианты ответов тем ссылаются на него
+    if (header.poolSize > 0) {
+        try {
+            m_stringPool = CourseCodec::decodeStringList(rawRegion(m_data, header.poolOffset, header.poolSize));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Failed to read string pool from: " + filePath.toStdString());
+        }
+    }
+
+    // Каталог ресурсов; данные ресурсов проверяются при чтении
+    if (hasAssets) {
+        if (!decodeAssetDirectory(rawRegion(m_data, header.assetsOffset(), header.assetsSize), m_assets)) {
+            throw std::runtime_error("Failed to read asset directory from: " + filePath.toStdString());
+        }
+        for (int i = m_assets.size() - 1; i >= 0; --i) {
+            const CourseFormat::AssetEntry& asset = m_assets[i];
+            if (asset.offset < CourseFormat::HeaderSize || !isInFile(asset.offset, asset.size, fileSize)) {
+                qWarning() << "Asset" << asset.name << "is out of file bounds in" << filePath;
+                m_assets.removeAt(i);
+            }
+        }
+        for (int i = 0; i < m_assets.size(); ++i) {
+            m_assetIndex.insert(m_assets[i].name, i);
+        }
+    }
+
+    QMutexLocker locker(&mappedFilesMutex());
+    ++mappedFiles()[QFileInfo(m_filePath).absoluteFilePath()];
+}
+
+CourseStorage::~CourseStorage() {
+    QMutexLocker locker(&mappedFilesMutex());
+    const QString key = QFileInfo(m_filePath).absoluteFilePath();
+    if (--mappedFiles()[key] <= 0) {
+        mappedFiles().remove(key);
+    }
+}
+
+bool CourseStorage::isMapped(const QString& filePath) {
+    QMutexLocker locker(&mappedFilesMutex());
+    return mappedFiles().contains(QFileInfo(filePath).absoluteFilePath());
+}
+
+CourseFormat::EncodedBlock CourseStorage::rawTopicBlock(int index) const {
+    if (index < 0 || index >= m_entries.size()) {
+        throw std::runtime_error("Invalid topic index in course container");
+    }
+
+    if (m_damaged.testBit(index)) {
+        throw std::runtime_error("Topic " + std::to_string(index) + " table entry is damaged in: "
+                                 + m_filePath.toStdString());
+    }
+
+    const CourseFormat::TableEntry& entry = m_entries[index];
+    if (m_version != CourseFormat::LegacyVersion
+        && Crc32c::compute(m_data + entry.offset, entry.size) != entry.checksum) {
+        throw std::runtime_error("Topic " + std::to_string(index) + " failed checksum verification in: "
+                                 + m_filePath.toStdString());
+    }
+
+    CourseFormat::EncodedBlock block;
+    block.data = rawRegion(m_data, entry.offset, entry.size);
+    block.encoding = entry.encoding;
+    return block;
+}
+
+QByteArray CourseStorage::asset(const QString& name) const {
+    const auto it = m_assetIndex.constFind(name);
+    if (it == m_assetIndex.constEnd()) {
+        return QByteArray();
+    }
+
+    const CourseFormat::AssetEntry& asset = m_assets[it.value()];
+    if (Crc32c::compute(m_data + asset.offset, asset.size) != asset.checksum) {
+        throw std::runtime_error("Asset " + name.toStdString() + " failed checksum verification in: "
+                                 + m_filePath.toStdString());
+    }
+    return rawRegion(m_data, asset.offset, asset.size);
+}
+
+QByteArray CourseStorage::topicPayload(int index, quint8& encoding) const {
+    const CourseFormat::EncodedBlock block = rawTopicBlock(index);
+    encoding = block.encoding;
+
+    // Распаковка выполняется только для открываемой темы
+    if (!isCompressedEncoding(block.encoding)) {
+        return block.data;
+    }
+
+    const QByteArray payload = qUncompress(block.data);
+    if (payload.isEmpty()) {
+        throw std::runtime_error("Failed to decompress topic " + std::to_string(index)
+                                 + " from: " + m_filePath.toStdString());
+    }
+    return payload;
+}
+
+void CourseStorage::readTopicBody(int index, Topic& topic, ValidationReport* report) const {
+    quint8 encoding = CourseFormat::Compact;
+    const QByteArray payload = topicPayload(index, encoding);
+
+    if (encoding != CourseFormat::DataStream && encoding != CourseFormat::DataStreamZlib) {
+        try {
+            if (encoding == CourseFormat::Pooled || encoding == CourseFormat::PooledZlib) {
+                CourseCodec::decodePooledTopicBody(payload, m_stringPool, topic, report);
+            } else {
+                CourseCodec::decodeTopicBody(payload, topic, report);
+            }
+        } catch (const std::exception&) {
+            throw std::runtime_error("Failed to decode topic " + std::to_string(index)
+                                     + " from: " + m_filePath.toStdString());
+        }
+        if (report) {
+            ++report->topicsChecked;
+        }
+        return;
+    }
+
+    // Блоки ранних файлов v2 в формате QDataStream
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    QString htmlContent;
+    QList<Question> questions;
+    stream >> htmlContent >> questions;
+
+    if (stream.status() != QDataStream::Ok) {
+        throw std::runtime_error("Failed to decode topic " + std::to_string(index)
+                                 + " from: " + m_filePath.toStdString());
+    }
+
+    topic.htmlContent = htmlContent;
+    topic.questions = questions;
+
+    // Вопросы в формате QDataStream проверяются в operator>> (формат v1)
+    if (report) {
+        ++report->topicsChecked;
+        report->questionsChecked += questions.size();
+    }
+}
+
+void CourseStorage::readTopicView(int index, const ArenaSpan<QStringView>& pool,
+                                  CourseArena& arena, TopicView& topic, ValidationReport* report) const {
+    quint8 encoding = CourseFormat::Compact;
+    const QByteArray payload = topicPayload(index, encoding);
+
+    if (encoding == CourseFormat::DataStream || encoding == CourseFormat::DataStreamZlib) {
+        // Блоки ранних файлов v2 декодируются через Topic и копируются в арену
+        Topic decoded;
+        readTopicBody(index, decoded, report);
+        const TopicView copied = TopicView::fromTopic(decoded, arena);
+        topic.htmlContent = copied.htmlContent;
+        topic.questions = copied.questions;
+        return;
+    }
+
+    try {
+        if (encoding == CourseFormat::Pooled || encoding == CourseFormat::PooledZlib) {
+            CourseCodec::decodePooledTopicView(payload, pool, arena, topic, report);
+        } else {
+            CourseCodec::decodeTopicView(payload, arena, topic, report);
+        }
+    } catch (const std::exception&) {
+        throw std::runtime_error("Failed to decode topic " + std::to_string(index)
+                                 + " from: " + m_filePath.toStdString());
+    }
+    if (report) {
+        ++report->topicsChecked;
+    }
+}
+
+// ==================== CourseWriter ====================
+
+CourseWriter::CourseWriter(const QString& filePath)
+    : m_filePath(filePath)
+    , m_file(filePath)
+{
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        throw std::runtime_error("Cannot open file for writing: " + filePath.toStdString());
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_5_15);
+
+    // Место под заголовок, который записывается последним
+    writeZeros(m_stream, CourseFormat::HeaderSize);
+}
+
+void CourseWriter::setStringPool(const QStringList& strings) {
+    m_pool = StringPool(strings);
+}
+
+void CourseWriter::addTopic(const Topic& topic) {
+    addEncodedTopic(topic.title, compressTopicPayload(encodeTopicPayload(topic)));
+}
+
+QByteArray CourseWriter::encodeTopicPayload(const Topic& topic) {
+    return CourseCodec::encodePooledTopicBody(topic, m_pool);
+}
+
+CourseFormat::EncodedBlock CourseWriter::compressTopicPayload(const QByteArray& payload) {
+    return compressTopicBody(payload, CourseFormat::Pooled);
+}
+
+void CourseWriter::addEncodedTopic(const QString& title, const CourseFormat::EncodedBlock& block) {
+    CourseFormat::TableEntry entry;
+    entry.offset = static_cast<quint64>(m_file.pos());
+    entry.size = static_cast<quint32>(block.data.size());
+    entry.encoding = block.encoding;
+    entry.checksum = Crc32c::compute(block.data.constData(), block.data.size());
+
+    if (m_stream.writeRawData(block.data.constData(), block.data.size()) != block.data.size()) {
+        throw std::runtime_error("Failed to serialize topic to: " + m_filePath.toStdString());
+    }
+
+    m_entries.append(entry);
+    m_titles.append(title);
+}
+
+void CourseWriter::addAsset(const QString& name, const QByteArray& data) {
+    CourseFormat::AssetEntry asset;
+    asset.name = name;
+    asset.offset = static_cast<quint64>(m_file.pos());
+    asset.size = static_cast<quint32>(data.size());
+    asset.checksum = Crc32c::compute(data.constData(), data.size());
+
+    if (m_stream.writeRawData(data.constData(), data.size()) != data.size()) {
+        throw std::runtime_error("Failed to write asset " + name.toStdString() + " to: " + m_filePath.toStdString());
+    }
+
+    for (int i = 0; i < m_assets.size(); ++i) {
+        if (m_assets[i].name == name) {
+            m_assets.removeAt(i);
+            break;
+        }
+    }
+    m_assets.append(asset);
+}
+
+void CourseWriter::commit() {
+    writeIndex();
+
+    QMutexLocker locker(&journalMutex());
+    if (!m_file.commit()) {
+        throw std::runtime_error("Failed to commit course data to: " + m_filePath.toStdString()
+                                 + " (" + m_file.errorString().toStdString() + ")");
+    }
+
+    qDebug() << "Course container written to" << m_filePath << "(" << m_entries.size() << "topics)";
+}
+
+bool CourseWriter::commitIfUnchanged(qint64 expectedSize, const QDateTime& expectedModified) {
+    writeIndex();
+
+    QMutexLocker locker(&journalMutex());
+    const QFileInfo current(m_filePath);
+    if (current.size() != expectedSize || current.lastModified() != expectedModified) {
+        m_file.cancelWriting();
+        return false;
+    }
+
+    if (!m_file.commit()) {
+        throw std::runtime_error("Failed to commit course data to: " + m_filePath.toStdString()
+                                 + " (" + m_file.errorString().toStdString() + ")");
+    }
+    return true;
+}
+
+void CourseWriter::writeIndex() {
+    // Выравниваем таблицу, чтобы запись таблицы не пересекала границу сектора
+    const int padding = static_cast<int>((CourseFormat::TableEntrySize
+                                          - m_file.pos() % CourseFormat::TableEntrySize)
+                                         % CourseFormat::TableEntrySize);
+    writeZeros(m_stream, padding);
+
+    const quint64 tableOffset = static_cast<quint64>(m_file.pos());
+    for (const CourseFormat::TableEntry& entry : m_entries) {
+        const QByteArray entryBytes = encodeTableEntry(entry);
+        m_stream.writeRawData(entryBytes.constData(), entryBytes.size());
+    }
+
+    const quint64 titlesOffset = static_cast<quint64>(m_file.pos());
+    const QByteArray titlesBlock = CourseCodec::encodeStringList(m_titles);
+    m_stream.writeRawData(titlesBlock.constData(), titlesBlock.size());
+    const quint64 titlesSize = static_cast<quint64>(titlesBlock.size());
+
+    const quint64 poolOffset = static_cast<quint64>(m_file.pos());
+    const QByteArray poolBlock = CourseCodec::encodeStringList(m_pool.strings());
+    m_stream.writeRawData(poolBlock.constData(), poolBlock.size());
+    const quint64 poolSize = static_cast<quint64>(poolBlock.size());
+
+    quint32 indexChecksum = Crc32c::compute(poolBlock.constData(), poolBlock.size(),
+                                            Crc32c::compute(titlesBlock.constData(), titlesBlock.size()));
+
+    // Каталог ресурсов следует сразу за пулом строк
+    quint16 flags = CourseFormat::FlagCompactTitles;
+    quint32 assetsSize = 0;
+    if (!m_assets.isEmpty()) {
+        const QByteArray assetsBlock = encodeAssetDirectory(m_assets);
+        m_stream.writeRawData(assetsBlock.constData(), assetsBlock.size());
+        indexChecksum = Crc32c::compute(assetsBlock.constData(), assetsBlock.size(), indexChecksum);
+        assetsSize = static_cast<quint32>(assetsBlock.size());
+        flags |= CourseFormat::FlagAssets;
+    }
+
+    // Заголовок записывается последним, когда известны все смещения
+    QByteArray headerBlock;
+    QDataStream headerStream(&headerBlock, QIODevice::WriteOnly);
+    headerStream << CourseFormat::Magic << CourseFormat::Version << flags
+                 << quint32(m_entries.size()) << assetsSize
+                 << tableOffset << titlesOffset << titlesSize << poolOffset << poolSize << indexChecksum;
+    writeZeros(headerStream, CourseFormat::HeaderChecksumOffset - headerBlock.size());
+    headerStream << Crc32c::compute(headerBlock.constData(), CourseFormat::HeaderChecksumOffset);
+
+    if (!m_file.seek(0)) {
+        throw std::runtime_error("Failed to write course container header: " + m_filePath.toStdString());
+    }
+    m_stream.writeRawData(headerBlock.constData(), headerBlock.size());
+
+    if (m_stream.status() != QDataStream::Ok) {
+        throw std::runtime_error("Failed to serialize course data to: " + m_filePath.toStdString());
+    }
+}
+
+// ==================== CourseJournal ====================
+
+bool CourseJournal::replaceTopic(const QString& filePath, int index, const Topic& topic) {
+    QMutexLocker locker(&journalMutex());
+
+    // ReadWrite создал бы пустой файл для встроенного курса, еще не сохраненного на диск
+    QFile file(filePath);
+    if (!file.exists() || !file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    // Контейнер v2 или с поврежденным заголовком переписывается целиком
+    const QByteArray headerBlock = file.read(CourseFormat::HeaderSize);
+    if (headerBlock.size() != CourseFormat::HeaderSize) {
+        return false;
+    }
+    QDataStream headerStream(headerBlock);
+    const Header header = readHeader(headerStream);
+    if (header.magic != CourseFormat::Magic || header.version != CourseFormat::Version
+        || !isHeaderIntact(headerBlock.constData())
+        || index < 0 || static_cast<quint32>(index) >= header.topicCount) {
+        return false;
+    }
+
+    // Название хранится в общем блоке названий: при его изменении нужна полная запись
+    if (!file.seek(static_cast<qint64>(header.titlesOffset))) {
+        return false;
+    }
+    const QByteArray titlesBlock = file.read(static_cast<qint64>(header.titlesSize));
+    QStringList titles;
+    if (!decodeTitlesBlock(titlesBlock, header.flags, titles)
+        || titles.size() != static_cast<int>(header.topicCount) || titles[index] != topic.title) {
+        return false;
+    }
+
+    // Пул строк не переписывается: если вариантов ответов нет в пуле,
+    // блок кодируется без ссылок на него
+    QStringList poolStrings;
+    if (header.poolSize > 0) {
+        if (!file.seek(static_cast<qint64>(header.poolOffset))) {
+            return false;
+        }
+        try {
+            poolStrings = CourseCodec::decodeStringList(file.read(static_cast<qint64>(header.poolSize)));
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    StringPool pool(poolStrings);
+    CourseFormat::EncodedBlock block = encodeTopicBody(topic, pool);
+    if (pool.size() != poolStrings.size()) {
+        block = compressTopicBody(CourseCodec::encodeTopicBody(topic), CourseFormat::Compact);
+    }
+
+    // 1. Дописываем новый блок темы в конец файла и сбрасываем его на диск.
+    //    Пока запись таблицы не обновлена, блок считается мертвым.
+    CourseFormat::TableEntry entry;
+    entry.offset = static_cast<quint64>(file.size());
+    entry.size = static_cast<quint32>(block.data.size());
+    entry.encoding = block.encoding;
+    entry.checksum = Crc32c::compute(block.data.constData(), block.data.size());
+    if (!file.seek(static_cast<qint64>(entry.offset))
+        || file.write(block.data) != block.data.size() || !syncToDisk(file)) {
+        throw std::runtime_error("Failed to append topic block to: " + filePath.toStdString());
+    }
+
+    // 2. Переключаем запись таблицы на новый блок. Запись выровнена на 32 байта,
+    //    не пересекает границу сектора и поэтому попадает на диск целиком или никак;
+    //    оборванная запись будет отвергнута по своей контрольной сумме.
+    const qint64 entryOffset = static_cast<qint64>(header.tableOffset)
+                               + qint64(index) * CourseFormat::TableEntrySize;
+    const QByteArray entryBytes = encodeTableEntry(entry);
+    if (!file.seek(entryOffset)) {
+        throw std::runtime_error("Failed to update topic table in: " + filePath.toStdString());
+    }
+    if (file.write(entryBytes) != entryBytes.size() || !syncToDisk(file)) {
+        throw std::runtime_error("Failed to update topic table in: " + filePath.toStdString());
+    }
+
+    qDebug() << "Topic" << index << "appended to" << filePath << "(" << block.data.size() << "bytes)";
+    return true;
+}
+
+bool CourseJournal::needsCompaction(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    const Header header = readHeader(stream);
+    if (stream.status() != QDataStream::Ok || header.magic != CourseFormat::Magic
+        || header.version != CourseFormat::Version
+        || !file.seek(static_cast<qint64>(header.tableOffset))) {
+        return false;
+    }
+
+    quint64 liveBytes = CourseFormat::HeaderSize + header.titlesSize + header.poolSize + header.assetsSize
+                        + quint64(header.topicCount) * CourseFormat::TableEntrySize;
+    for (quint32 i = 0; i < header.topicCount; ++i) {
+        CourseFormat::TableEntry entry;
+        decodeTableEntry(file.read(CourseFormat::TableEntrySize), header.version, entry);
+        liveBytes += entry.size;
+    }
+
+    // Ресурсы не меняются журналом и всегда живые
+    QVector<CourseFormat::AssetEntry> assets;
+    if ((header.flags & CourseFormat::FlagAssets) && file.seek(static_cast<qint64>(header.assetsOffset()))
+        && decodeAssetDirectory(file.read(header.assetsSize), assets)) {
+        for (const CourseFormat::AssetEntry& asset : assets) {
+            liveBytes += asset.size;
+        }
+    }
+
+    const quint64 fileSize = static_cast<quint64>(file.size());
+    const quint64 deadBytes = fileSize > liveBytes ? fileSize - liveBytes : 0;
+    return deadBytes >= MinCompactionBytes && deadBytes >= liveBytes;
+}
+
+bool CourseJournal::compact(const QString& filePath) {
+    // В Windows отображенный в память файл нельзя заменить
+    if (CourseStorage::isMapped(filePath)) {
+        qDebug() << "Course file is open, compaction postponed:" << filePath;
+        return false;
+    }
+
+    CourseWriter writer(filePath);
+    qint64 sizeBefore = 0;
+    QDateTime modifiedBefore;
+    {
+        // Журнал не дописывает файл, пока он копируется; собственное отображение
+        // закрывается до замены файла
+        QMutexLocker locker(&journalMutex());
+        const QFileInfo before(filePath);
+        sizeBefore = before.size();
+        modifiedBefore = before.lastModified();
+
+        // Живые блоки копируются как есть, без декодирования тем
+        const CourseStorage storage(filePath);
+        writer.setStringPool(storage.stringPool());
+        for (int i = 0; i < storage.topicCount(); ++i) {
+            writer.addEncodedTopic(storage.titles()[i], storage.rawTopicBlock(i));
+        }
+        for (const CourseFormat::AssetEntry& asset : storage.assets()) {
+            writer.addAsset(asset.name, storage.asset(asset.name));
+        }
+    }
+
+    if (!writer.commitIfUnchanged(sizeBefore, modifiedBefore)) {
+        qDebug() << "Course file changed during compaction, compaction postponed:" << filePath;
+        return false;
+    }
+
+    qDebug() << "Course file compacted:" << filePath << "(" << sizeBefore << "->"
+             << QFileInfo(filePath).size() << "bytes)";
+    return true;
+}
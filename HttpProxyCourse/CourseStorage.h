@@ -0,0 +1,412 @@
+#pragma once
+
+#include "DomainTypes.h"
+#include "CourseCodec.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QBitArray>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QHash>
+
+/**
+ * @brief Константы формата контейнера курса course.dat v3.
+ *
+ * Раскладка файла:
+ * - заголовок фиксированного размера (HeaderSize байт) по нулевому смещению;
+ * - блоки тем (теория и вопросы), каждый сжимается и декодируется независимо;
+ * - таблица смещений: topicCount записей по TableEntrySize байт, выровненная на TableEntrySize;
+ * - блок заголовков тем, декодируемый при открытии файла;
+ * - пул строк (уникальные варианты ответов), на которые блоки тем ссылаются по индексу;
+ * - каталог ресурсов (изображения и другие файлы, на которые ссылается HTML теории),
+ *   если в заголовке установлен FlagAssets. Сами ресурсы хранятся несжатыми
+ *   отдельными блоками и читаются прямо из отображенной памяти.
+ *
+ * Поля заголовка и таблицы записываются в порядке big-endian (QDataStream),
+ * содержимое блоков — компактным кодеком CourseCodec. Блоки в формате
+ * QDataStream из ранних файлов v2 по-прежнему читаются.
+ *
+ * Целостность проверяется CRC32C (см. Crc32c): заголовок, блоки названий
+ * и пула и каталог ресурсов — при открытии файла, ресурс — при его чтении, каждая запись таблицы — своей суммой,
+ * блок темы — суммой из записи таблицы при чтении темы. Поврежденная тема
+ * не мешает загрузке остальных. Файлы v2 контрольных сумм не содержат.
+ */
+namespace CourseFormat {
+    /// @brief Сигнатура контейнера ("HPCC").
+    constexpr quint32 Magic = 0x48504343;
+
+    /// @brief Текущая версия формата контейнера.
+    constexpr quint16 Version = 3;
+
+    /// @brief Версия без контрольных сумм, которая по-прежнему читается.
+    constexpr quint16 LegacyVersion = 2;
+
+    /// @brief Размер заголовка файла в байтах.
+    constexpr int HeaderSize = 64;
+
+    /// @brief Смещение контрольной суммы заголовка (последние 4 байта заголовка).
+    constexpr int HeaderChecksumOffset = HeaderSize - 4;
+
+    /// @brief Размер одной записи таблицы смещений в байтах.
+    constexpr int TableEntrySize = 32;
+
+    /// @brief Размер записи таблицы смещений в файлах v2.
+    constexpr int LegacyTableEntrySize = 16;
+
+    /// @brief Флаг заголовка: блок названий закодирован CourseCodec (иначе QStringList в QDataStream).
+    constexpr quint16 FlagCompactTitles = 0x0001;
+
+    /// @brief Флаг заголовка: за пулом строк следует каталог ресурсов, его размер — в поле assetsSize.
+    constexpr quint16 FlagAssets = 0x0002;
+
+    /**
+     * @brief Способ кодирования блока темы.
+     */
+    enum BlockEncoding : quint8 {
+        DataStream = 0,      ///< Поток QDataStream без сжатия
+        DataStreamZlib = 1,  ///< Поток QDataStream, сжатый qCompress
+        Compact = 2,         ///< Кодек CourseCodec без сжатия
+        CompactZlib = 3,     ///< Кодек CourseCodec, сжатый qCompress
+        Pooled = 4,          ///< Кодек CourseCodec, варианты ответов — индексы пула строк
+        PooledZlib = 5       ///< То же, сжатое qCompress
+    };
+
+    /**
+     * @brief Запись таблицы смещений.
+     *
+     * offset u64, size u32, encoding u8, зарезервировано 3 байта, checksum u32,
+     * CRC32C предыдущих 20 байт записи u32, дополнение нулями до TableEntrySize.
+     * В файлах v2 запись заканчивается после зарезервированных байтов.
+     */
+    struct TableEntry {
+        quint64 offset = 0;    ///< Смещение блока темы от начала файла
+        quint32 size = 0;      ///< Размер блока темы в байтах
+        quint8 encoding = Compact;  ///< Способ кодирования блока (BlockEncoding)
+        quint32 checksum = 0;  ///< CRC32C блока темы
+    };
+
+    /**
+     * @brief Запись каталога ресурсов.
+     */
+    struct AssetEntry {
+        QString name;          ///< Относительный путь ресурса, как в HTML (например, "assets/proxy.png")
+        quint64 offset = 0;    ///< Смещение данных ресурса от начала файла
+        quint32 size = 0;      ///< Размер данных ресурса в байтах
+        quint32 checksum = 0;  ///< CRC32C данных ресурса
+    };
+
+    /**
+     * @brief Закодированный блок темы вместе со способом кодирования.
+     */
+    struct EncodedBlock {
+        QByteArray data;          ///< Содержимое блока
+        quint8 encoding = Compact;  ///< Способ кодирования (BlockEncoding)
+    };
+}
+
+/**
+ * @brief Отображенный в память контейнер курса (course.dat v2/v3).
+ *
+ * При открытии декодирует только заголовок, таблицу смещений и названия тем.
+ * Тело темы (HTML и вопросы) декодируется по запросу прямо из отображенной памяти.
+ * Чтение тем не изменяет состояние объекта и безопасно из нескольких потоков.
+ */
+class CourseStorage {
+public:
+    /**
+     * @brief Проверяет, является ли файл контейнером курса.
+     * @param filePath Путь к файлу курса.
+     * @return true, если файл начинается с сигнатуры контейнера.
+     */
+    static bool isContainer(const QString& filePath);
+
+    /**
+     * @brief Открывает контейнер и отображает его в память.
+     * @param filePath Путь к файлу курса.
+     * @throws std::runtime_error Если файл не открылся, не отображается в память,
+     *         поврежден заголовок, названия тем или пул строк.
+     */
+    explicit CourseStorage(const QString& filePath);
+
+    ~CourseStorage();
+
+    /**
+     * @brief Проверяет, открыт ли файл каким-либо CourseStorage в этом процессе.
+     * @param filePath Путь к файлу курса.
+     */
+    static bool isMapped(const QString& filePath);
+
+    CourseStorage(const CourseStorage&) = delete;
+    CourseStorage& operator=(const CourseStorage&) = delete;
+
+    /**
+     * @brief Возвращает путь к файлу контейнера.
+     */
+    const QString& filePath() const { return m_filePath; }
+
+    /**
+     * @brief Возвращает количество тем в контейнере.
+     */
+    int topicCount() const { return m_entries.size(); }
+
+    /**
+     * @brief Возвращает названия всех тем в порядке следования.
+     */
+    const QStringList& titles() const { return m_titles; }
+
+    /**
+     * @brief Возвращает пул строк контейнера (уникальные варианты ответов).
+     *
+     * Декодируется один раз при открытии; варианты ответов всех загруженных
+     * тем разделяют данные с этими строками.
+     */
+    const QStringList& stringPool() const { return m_stringPool; }
+
+    /**
+     * @brief Декодирует (и при необходимости распаковывает) теорию и вопросы темы.
+     * @param index Индекс темы (0-based).
+     * @param topic Тема для заполнения; заголовок не изменяется.
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    void readTopicBody(int index, Topic& topic, ValidationReport* report = nullptr) const;
+
+    /**
+     * @brief Проверяет, повреждена ли запись таблицы смещений темы.
+     *
+     * Запись проверяется при открытии файла; содержимое блока темы
+     * проверяется только при его чтении.
+     *
+     * @param index Индекс темы (0-based).
+     */
+    bool isTopicDamaged(int index) const { return m_damaged.testBit(index); }
+
+    /**
+     * @brief Возвращает контрольную сумму блока темы из таблицы смещений.
+     * @param index Индекс темы (0-based).
+     * @return CRC32C блока; 0 для файлов v2 без контрольных сумм.
+     */
+    quint32 topicChecksum(int index) const { return m_entries[index].checksum; }
+
+    /**
+     * @brief Возвращает закодированный блок темы без копирования и распаковки.
+     *
+     * Контрольная сумма блока проверяется до возврата, поэтому поврежденный
+     * блок не может быть ни декодирован, ни скопирован при уплотнении.
+     *
+     * @param index Индекс темы (0-based).
+     * @return Блок поверх отображенной памяти; действителен, пока жив объект.
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    CourseFormat::EncodedBlock rawTopicBlock(int index) const;
+
+    /**
+     * @brief Декодирует теорию и вопросы темы в арену, без отдельных QString.
+     * @param index Индекс темы (0-based).
+     * @param pool Пул строк контейнера, предварительно скопированный в ту же арену.
+     * @param arena Арена для строк и массивов темы.
+     * @param topic Тема для заполнения; заголовок не изменяется.
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    void readTopicView(int index, const ArenaSpan<QStringView>& pool, CourseArena& arena, TopicView& topic,
+                       ValidationReport* report = nullptr) const;
+
+    /**
+     * @brief Возвращает каталог ресурсов контейнера.
+     */
+    const QVector<CourseFormat::AssetEntry>& assets() const { return m_assets; }
+
+    /**
+     * @brief Возвращает данные ресурса без копирования.
+     *
+     * Контрольная сумма проверяется при каждом вызове; вызывающая сторона
+     * кэширует декодированный результат (см. CourseAssetCache).
+     *
+     * @param name Относительный путь ресурса.
+     * @return Данные поверх отображенной памяти (действительны, пока жив объект);
+     *         пустой массив, если ресурса нет.
+     * @throws std::runtime_error Если данные ресурса повреждены.
+     */
+    QByteArray asset(const QString& name) const;
+
+private:
+    /**
+     * @brief Возвращает несжатое содержимое блока темы.
+     * @param index Индекс темы (0-based).
+     * @param encoding Способ кодирования блока.
+     * @throws std::runtime_error Если индекс неверный или блок не распаковывается.
+     */
+    QByteArray topicPayload(int index, quint8& encoding) const;
+
+    QString m_filePath;          ///< Путь к файлу контейнера
+    quint16 m_version;           ///< Версия формата файла
+    QFile m_file;                ///< Открытый файл (должен жить, пока жива проекция)
+    const uchar* m_data;         ///< Начало отображенной области
+    qint64 m_size;               ///< Размер отображенной области
+    QVector<CourseFormat::TableEntry> m_entries;  ///< Таблица смещений тем
+    QBitArray m_damaged;         ///< Темы с поврежденной записью таблицы
+    QStringList m_titles;        ///< Названия тем
+    QStringList m_stringPool;    ///< Пул строк для блоков Pooled/PooledZlib
+    QVector<CourseFormat::AssetEntry> m_assets;  ///< Каталог ресурсов
+    QHash<QString, int> m_assetIndex;            ///< Имя ресурса -> индекс в m_assets
+};
+
+/**
+ * @brief Последовательная запись контейнера курса v3.
+ *
+ * Темы добавляются по одной, поэтому в памяти одновременно держится
+ * только одна тема, а также таблица смещений и названия.
+ * Файл записывается через QSaveFile и подменяет старый только при commit(),
+ * поэтому отображенный в память прежний файл остается корректным.
+ */
+class CourseWriter {
+public:
+    /**
+     * @brief Создает писатель и открывает временный файл.
+     * @param filePath Итоговый путь к файлу курса.
+     * @throws std::runtime_error Если не удалось открыть файл для записи.
+     */
+    explicit CourseWriter(const QString& filePath);
+
+    CourseWriter(const CourseWriter&) = delete;
+    CourseWriter& operator=(const CourseWriter&) = delete;
+
+    /**
+     * @brief Задает начальное содержимое пула строк.
+     *
+     * Нужно при копировании блоков из другого контейнера через addEncodedTopic():
+     * индексы пула в скопированных блоках остаются действительными.
+     * Вызывается до добавления первой темы.
+     *
+     * @param strings Пул строк исходного контейнера.
+     */
+    void setStringPool(const QStringList& strings);
+
+    /**
+     * @brief Кодирует, сжимает и записывает очередную тему.
+     * @param topic Тема с загруженными теорией и вопросами.
+     * @throws std::runtime_error При ошибке записи.
+     */
+    void addTopic(const Topic& topic);
+
+    /**
+     * @brief Кодирует тему со ссылками на пул строк писателя, без сжатия.
+     *
+     * Пул строк общий для всего файла, поэтому вызовы выполняются
+     * последовательно в порядке записи тем.
+     *
+     * @param topic Тема с загруженными теорией и вопросами.
+     * @return Несжатое тело темы для compressTopicPayload().
+     */
+    QByteArray encodeTopicPayload(const Topic& topic);
+
+    /**
+     * @brief Сжимает тело темы, полученное от encodeTopicPayload().
+     *
+     * Не обращается к состоянию писателя и может выполняться параллельно
+     * для разных тем; результат передается в addEncodedTopic().
+     *
+     * @param payload Несжатое тело темы.
+     * @return Блок темы в формате контейнера.
+     */
+    static CourseFormat::EncodedBlock compressTopicPayload(const QByteArray& payload);
+
+    /**
+     * @brief Записывает уже закодированный блок темы (например, скопированный из другого контейнера).
+     * @param title Название темы.
+     * @param block Блок темы в формате контейнера.
+     * @throws std::runtime_error При ошибке записи.
+     */
+    void addEncodedTopic(const QString& title, const CourseFormat::EncodedBlock& block);
+
+    /**
+     * @brief Записывает ресурс (изображение или другой файл) без сжатия.
+     *
+     * Форматы изображений уже сжаты, а несжатый блок читается из отображенной
+     * памяти без копирования. Повторное имя заменяет прежний ресурс в каталоге.
+     *
+     * @param name Относительный путь ресурса, по которому на него ссылается HTML.
+     * @param data Содержимое ресурса.
+     * @throws std::runtime_error При ошибке записи.
+     */
+    void addAsset(const QString& name, const QByteArray& data);
+
+    /**
+     * @brief Дописывает таблицу смещений, названия, пул строк, каталог ресурсов и заголовок и фиксирует файл.
+     * @throws std::runtime_error При ошибке записи или фиксации файла.
+     */
+    void commit();
+
+    /**
+     * @brief Фиксирует файл, только если целевой файл не менялся с момента начала записи.
+     * @param expectedSize Размер целевого файла на момент начала записи.
+     * @param expectedModified Время изменения целевого файла на момент начала записи.
+     * @return true, если файл зафиксирован; false, если запись отменена.
+     * @throws std::runtime_error При ошибке записи или фиксации файла.
+     */
+    bool commitIfUnchanged(qint64 expectedSize, const QDateTime& expectedModified);
+
+private:
+    /**
+     * @brief Дописывает таблицу смещений, названия, пул строк, каталог ресурсов и заголовок.
+     */
+    void writeIndex();
+
+    QString m_filePath;                ///< Итоговый путь к файлу
+    QSaveFile m_file;                  ///< Временный файл до commit()
+    QDataStream m_stream;              ///< Поток записи
+    QVector<CourseFormat::TableEntry> m_entries;  ///< Смещения и размеры записанных блоков
+    QStringList m_titles;              ///< Названия записанных тем
+    StringPool m_pool;                 ///< Уникальные варианты ответов записанных тем
+    QVector<CourseFormat::AssetEntry> m_assets;  ///< Записанные ресурсы
+};
+
+/**
+ * @brief Поблочное обновление контейнера курса без его перезаписи.
+ *
+ * Новая версия темы дописывается в конец файла, после чего на месте
+ * переключается одна запись таблицы смещений. Старый блок становится мертвым
+ * и удаляется при уплотнении. Пул строк при этом не меняется: если в теме
+ * появились новые варианты ответов, блок записывается без ссылок на пул. Сбой в любой момент оставляет файл согласованным:
+ * до переключения записи таблицы действует прежняя версия темы.
+ */
+class CourseJournal {
+public:
+    /// @brief Минимальный объем мертвых блоков, при котором имеет смысл уплотнение.
+    static constexpr quint64 MinCompactionBytes = 64 * 1024;
+
+    /**
+     * @brief Заменяет теорию и вопросы одной темы в контейнере.
+     * @param filePath Путь к файлу контейнера.
+     * @param index Индекс темы (0-based).
+     * @param topic Новое содержимое темы.
+     * @return false, если файл не является контейнером текущей версии с такой темой
+     *         (например, изменилось название) и нужна полная запись курса.
+     * @throws std::runtime_error При ошибке записи.
+     */
+    static bool replaceTopic(const QString& filePath, int index, const Topic& topic);
+
+    /**
+     * @brief Проверяет, занимают ли мертвые блоки не меньше половины файла.
+     * @param filePath Путь к файлу контейнера.
+     */
+    static bool needsCompaction(const QString& filePath);
+
+    /**
+     * @brief Переписывает контейнер, оставляя только живые блоки.
+     *
+     * Отображенный файл в Windows заменить нельзя, поэтому уплотнение выполняется
+     * при загрузке курса, до открытия файла, и пропускается, пока файл открыт
+     * (CourseStorage::isMapped()). Если во время уплотнения файл был изменен,
+     * результат отбрасывается.
+     *
+     * @param filePath Путь к файлу контейнера.
+     * @return true, если файл уплотнен.
+     * @throws std::runtime_error При ошибке чтения или записи.
+     */
+    static bool compact(const QString& filePath);
+};
@@ -0,0 +1,147 @@
+#include "Crc32c.h"
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86_64) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#include <nmmintrin.h>
+#define HPC_CRC32C_X86 1
+#define HPC_CRC32C_TARGET __attribute__((target("sse4.2")))
+#elif defined(Q_PROCESSOR_X86_64) && defined(Q_CC_MSVC)
+#include <intrin.h>
+#include <nmmintrin.h>
+#define HPC_CRC32C_X86 1
+#define HPC_CRC32C_TARGET
+#elif defined(Q_PROCESSOR_ARM_64) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define HPC_CRC32C_ARM 1
+#endif
+
+namespace {
+
+/// @brief Отраженный полином CRC32C.
+constexpr quint32 Polynomial = 0x82F63B78;
+
+/**
+ * @brief Таблицы алгоритма slicing-by-8.
+ */
+struct Tables {
+    quint32 data[8][256];
+
+    Tables() {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (Polynomial & (0u - (crc & 1)));
+            }
+            data[0][i] = crc;
+        }
+        for (quint32 i = 0; i < 256; ++i) {
+            for (int slice = 1; slice < 8; ++slice) {
+                data[slice][i] = (data[slice - 1][i] >> 8) ^ data[0][data[slice - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Tables& tables() {
+    static const Tables instance;
+    return instance;
+}
+
+/**
+ * @brief Программная реализация (slicing-by-8), работает на любой платформе.
+ */
+quint32 computeSoftware(const uchar* pos, qint64 size, quint32 crc) {
+    const Tables& t = tables();
+    while (size >= 8) {
+        // Байты собираются вручную, чтобы результат не зависел от порядка байтов платформы
+        const quint32 low = crc ^ (quint32(pos[0]) | quint32(pos[1]) << 8
+                                   | quint32(pos[2]) << 16 | quint32(pos[3]) << 24);
+        crc = t.data[7][low & 0xFF] ^ t.data[6][(low >> 8) & 0xFF]
+              ^ t.data[5][(low >> 16) & 0xFF] ^ t.data[4][low >> 24]
+              ^ t.data[3][pos[4]] ^ t.data[2][pos[5]] ^ t.data[1][pos[6]] ^ t.data[0][pos[7]];
+        pos += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t.data[0][(crc ^ *pos++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(HPC_CRC32C_X86)
+
+/**
+ * @brief Реализация на инструкции crc32 из SSE4.2.
+ */
+HPC_CRC32C_TARGET quint32 computeHardware(const uchar* pos, qint64 size, quint32 crc) {
+    quint64 crc64 = crc;
+    while (size >= 8) {
+        quint64 chunk;
+        std::memcpy(&chunk, pos, sizeof(chunk));
+        crc64 = _mm_crc32_u64(crc64, chunk);
+        pos += 8;
+        size -= 8;
+    }
+    crc = static_cast<quint32>(crc64);
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *pos++);
+    }
+    return crc;
+}
+
+bool detectHardware() {
+#if defined(Q_CC_MSVC)
+    int info[4] = {};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+#elif defined(HPC_CRC32C_ARM)
+
+/**
+ * @brief Реализация на инструкциях crc32c* из ARMv8.
+ */
+quint32 computeHardware(const uchar* pos, qint64 size, quint32 crc) {
+    while (size >= 8) {
+        quint64 chunk;
+        std::memcpy(&chunk, pos, sizeof(chunk));
+        crc = __crc32cd(crc, chunk);
+        pos += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = __crc32cb(crc, *pos++);
+    }
+    return crc;
+}
+
+bool detectHardware() {
+    return true;  // Расширение гарантировано флагами компиляции
+}
+
+#endif
+
+} // namespace
+
+quint32 Crc32c::compute(const void* data, qint64 size, quint32 crc) {
+    const uchar* pos = static_cast<const uchar*>(data);
+    crc = ~crc;
+#if defined(HPC_CRC32C_X86) || defined(HPC_CRC32C_ARM)
+    if (isHardwareAccelerated()) {
+        return ~computeHardware(pos, size, crc);
+    }
+#endif
+    return ~computeSoftware(pos, size, crc);
+}
+
+bool Crc32c::isHardwareAccelerated() {
+#if defined(HPC_CRC32C_X86) || defined(HPC_CRC32C_ARM)
+    static const bool supported = detectHardware();
+    return supported;
+#else
+    return false;
+#endif
+}
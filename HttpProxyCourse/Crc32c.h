@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @brief Контрольная сумма CRC32C (полином Castagnoli).
+ *
+ * Используется для проверки заголовка, таблицы и блоков контейнера course.dat.
+ * На x86 с SSE4.2 и на ARMv8 с расширением CRC32 вычисляется аппаратной
+ * инструкцией (наличие определяется во время выполнения на x86),
+ * в остальных случаях — табличным алгоритмом slicing-by-8.
+ */
+class Crc32c {
+public:
+    /**
+     * @brief Вычисляет CRC32C участка памяти.
+     * @param data Начало данных.
+     * @param size Размер данных в байтах.
+     * @param crc Значение для продолжения расчета по частям (0 для нового расчета).
+     * @return Контрольная сумма.
+     */
+    static quint32 compute(const void* data, qint64 size, quint32 crc = 0);
+
+    /**
+     * @brief Проверяет, используется ли аппаратная реализация.
+     */
+    static bool isHardwareAccelerated();
+};
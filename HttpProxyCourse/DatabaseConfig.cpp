@@ -8,6 +8,13 @@ DatabaseConfig::DatabaseConfig()
     , m_userName("postgres")
     , m_password("postgres")
     , m_port(5432)
+    , m_poolSize(4)
+    , m_idleTimeout(300)
+    , m_warmupConnections(2)
+    , m_checkInterval(60)
+    , m_acquireTimeout(5000)
+    , m_progressFlushInterval(30)
+    , m_resultFlushLatency(1000)
 {
     // Значения по умолчанию установлены в списке инициализации
 }
@@ -37,8 +44,28 @@ void DatabaseConfig::loadConfig(const QString& configPath) {
     m_port = settings.value("port", m_port).toInt();
     settings.endGroup();
 
+    // Параметры пула соединений из секции [Pool]
+    settings.beginGroup("Pool");
+    m_poolSize = qMax(1, settings.value("size", m_poolSize).toInt());
+    m_idleTimeout = qMax(1, settings.value("idle_timeout", m_idleTimeout).toInt());
+    m_warmupConnections = qBound(0, settings.value("warmup", m_warmupConnections).toInt(), m_poolSize - 1);
+    m_checkInterval = qMax(0, settings.value("check_interval", m_checkInterval).toInt());
+    m_acquireTimeout = qMax(0, settings.value("acquire_timeout", m_acquireTimeout).toInt());
+    settings.endGroup();
+
+    // Отложенная запись прогресса из секции [Progress]
+    settings.beginGroup("Progress");
+    m_progressFlushInterval = qMax(1, settings.value("flush_interval", m_progressFlushInterval).toInt());
+    settings.endGroup();
+
+    // Очередь результатов тестов из секции [Results]
+    settings.beginGroup("Results");
+    m_resultFlushLatency = qMax(0, settings.value("flush_latency", m_resultFlushLatency).toInt());
+    settings.endGroup();
+
     qDebug() << "Конфигурация БД загружена из" << configPath;
     qDebug() << "Хост:" << m_hostName << "База:" << m_databaseName << "Порт:" << m_port;
+    qDebug() << "Пул соединений:" << m_poolSize << "Заранее:" << m_warmupConnections;
 }
 
 void DatabaseConfig::createDefaultConfig(const QString& configPath) {
@@ -53,6 +80,25 @@ void DatabaseConfig::createDefaultConfig(const QString& configPath) {
     settings.setValue("port", m_port);
     settings.endGroup();
 
+    // Записываем параметры пула соединений в секцию [Pool]
+    settings.beginGroup("Pool");
+    settings.setValue("size", m_poolSize);
+    settings.setValue("idle_timeout", m_idleTimeout);
+    settings.setValue("warmup", m_warmupConnections);
+    settings.setValue("check_interval", m_checkInterval);
+    settings.setValue("acquire_timeout", m_acquireTimeout);
+    settings.endGroup();
+
+    // Записываем параметры отложенной записи прогресса в секцию [Progress]
+    settings.beginGroup("Progress");
+    settings.setValue("flush_interval", m_progressFlushInterval);
+    settings.endGroup();
+
+    // Записываем параметры очереди результатов тестов в секцию [Results]
+    settings.beginGroup("Results");
+    settings.setValue("flush_latency", m_resultFlushLatency);
+    settings.endGroup();
+
     // Добавляем комментарии в начало файла
     settings.sync();
     
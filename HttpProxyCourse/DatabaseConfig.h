@@ -53,6 +53,48 @@ public:
      */
     int port() const { return m_port; }
 
+    /*!
+     * @brief Получить наибольшее число одновременно открытых соединений.
+     * @return Размер пула соединений.
+     */
+    int poolSize() const { return m_poolSize; }
+
+    /*!
+     * @brief Получить время простоя, после которого соединение рабочего потока закрывается.
+     * @return Время простоя в секундах.
+     */
+    int idleTimeout() const { return m_idleTimeout; }
+
+    /*!
+     * @brief Получить число соединений, открываемых заранее при запуске.
+     * @return Число соединений рабочих потоков.
+     */
+    int warmupConnections() const { return m_warmupConnections; }
+
+    /*!
+     * @brief Получить время простоя, после которого соединение проверяется перед выдачей.
+     * @return Интервал проверки в секундах.
+     */
+    int checkInterval() const { return m_checkInterval; }
+
+    /*!
+     * @brief Получить время ожидания свободного места в пуле.
+     * @return Время ожидания в миллисекундах.
+     */
+    int acquireTimeout() const { return m_acquireTimeout; }
+
+    /*!
+     * @brief Получить период записи накопленного прогресса в БД.
+     * @return Период в секундах.
+     */
+    int progressFlushInterval() const { return m_progressFlushInterval; }
+
+    /*!
+     * @brief Получить наибольшую задержку записи результата теста в БД.
+     * @return Задержка в миллисекундах.
+     */
+    int resultFlushLatency() const { return m_resultFlushLatency; }
+
 private:
     /*!
      * @brief Приватный конструктор для реализации паттерна Singleton.
@@ -76,4 +118,11 @@ private:
     QString m_userName;      ///< Имя пользователя БД
     QString m_password;      ///< Пароль пользователя БД
     int m_port;              ///< Порт БД
+    int m_poolSize;          ///< Наибольшее число соединений
+    int m_idleTimeout;       ///< Простой до закрытия соединения рабочего потока (с)
+    int m_warmupConnections; ///< Соединения, открываемые при запуске
+    int m_checkInterval;     ///< Простой до проверки соединения (с)
+    int m_acquireTimeout;    ///< Ожидание свободного места в пуле (мс)
+    int m_progressFlushInterval; ///< Период записи прогресса (с)
+    int m_resultFlushLatency;    ///< Задержка записи результатов тестов (мс)
 };
\ No newline at end of file
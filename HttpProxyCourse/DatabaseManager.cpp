@@ -4,16 +4,45 @@
 #include <QDebug>
 #include <QCryptographicHash>
 #include <QMutexLocker>
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadStorage>
 
-DatabaseManager::DatabaseManager() : m_connected(false) {
-    // Инициализация подключения к БД
-    m_database = QSqlDatabase::addDatabase("QPSQL");
+namespace {
+
+/**
+ * @brief Освобождает соединение потока при его завершении (через QThreadStorage).
+ */
+struct ThreadConnectionGuard {
+    DatabaseManager* manager;
+    ~ThreadConnectionGuard() { manager->releaseThreadConnection(); }
+};
+
+QThreadStorage<ThreadConnectionGuard*>& threadGuards() {
+    static QThreadStorage<ThreadConnectionGuard*> guards;
+    return guards;
 }
 
-DatabaseManager::~DatabaseManager() {
-    if (m_database.isOpen()) {
-        m_database.close();
+} // namespace
+
+DatabaseManager::DatabaseManager() : m_nextConnectionId(0), m_connected(false) {
+    if (!QSqlDatabase::isDriverAvailable("QPSQL")) {
+        qWarning() << "QPSQL driver is not available";
     }
+
+    // Реестр соединений Qt создается до завершения конструктора, поэтому
+    // уничтожается позже пула, и соединения можно закрыть в деструкторе
+    QSqlDatabase::contains(QString());
+    m_clock.start();
+}
+
+DatabaseManager::~DatabaseManager() {
+    m_workers.clear();
+    m_workers.waitForDone();
+    releaseThreadConnection();
 }
 
 DatabaseManager& DatabaseManager::instance() {
@@ -22,9 +51,7 @@ DatabaseManager& DatabaseManager::instance() {
 }
 
 bool DatabaseManager::connectDb() {
-    QMutexLocker locker(&m_mutex);
-    
-    if (m_connected && m_database.isOpen()) {
+    if (m_connected) {
         return true;
     }
 
@@ -32,21 +59,19 @@ bool DatabaseManager::connectDb() {
     DatabaseConfig& config = DatabaseConfig::instance();
     config.loadConfig();
 
-    // Настройка параметров подключения из конфигурации
-    m_database.setHostName(config.hostName());
-    m_database.setDatabaseName(config.databaseName());
-    m_database.setUserName(config.userName());
-    m_database.setPassword(config.password());
-    m_database.setPort(config.port());
-
-    if (!m_database.open()) {
-        qCritical() << "Failed to connect to database:" << m_database.lastError().text();
+    // Один поток пула оставляем под соединение главного потока
+    m_workers.setMaxThreadCount(qMax(1, config.poolSize() - 1));
+    m_workers.setExpiryTimeout(config.idleTimeout() * 1000);
+
+    // Соединение главного потока открывается первым и проверяет параметры подключения
+    m_connected = true;
+    if (!database().isOpen()) {
         m_connected = false;
         return false;
     }
 
     qDebug() << "Successfully connected to PostgreSQL database";
-    m_connected = true;
+    warmUp(config.warmupConnections());
     return true;
 }
 
@@ -71,15 +96,203 @@ bool DatabaseManager::initSchema() {
 }
 
 bool DatabaseManager::isConnected() const {
-    return m_connected && m_database.isOpen();
+    return m_connected;
 }
 
-QSqlDatabase& DatabaseManager::database() {
-    return m_database;
+QSqlDatabase DatabaseManager::database() {
+    if (!m_connected) {
+        return QSqlDatabase();
+    }
+
+    const Qt::HANDLE thread = QThread::currentThreadId();
+    QMutexLocker locker(&m_mutex);
+    auto it = m_connections.find(thread);
+    if (it != m_connections.end()) {
+        const qint64 now = m_clock.elapsed();
+        const bool stale = now - it->lastUsed > DatabaseConfig::instance().checkInterval() * 1000LL;
+        it->lastUsed = now;
+        QSqlDatabase db = QSqlDatabase::database(it->name, false);
+        locker.unlock();
+
+        if (stale || !db.isOpen()) {
+            ensureAlive(db);
+        }
+        return db;
+    }
+
+    // Поток сверх размера пула ждет, пока другой поток освободит соединение
+    const DatabaseConfig& config = DatabaseConfig::instance();
+    QDeadlineTimer deadline(config.acquireTimeout());
+    while (m_connections.size() >= config.poolSize()) {
+        if (!m_connectionReleased.wait(&m_mutex, deadline)) {
+            qWarning() << "Database connection pool exhausted:" << m_connections.size() << "connections in use";
+            return QSqlDatabase();
+        }
+    }
+
+    PooledConnection connection;
+    connection.name = QString("proxy_course_%1").arg(++m_nextConnectionId);
+    connection.lastUsed = m_clock.elapsed();
+    m_connections.insert(thread, connection);
+    locker.unlock();
+
+    // Соединение закрывается при завершении потока; соединение главного потока — в деструкторе
+    const QCoreApplication* app = QCoreApplication::instance();
+    const bool mainThread = app && QThread::currentThread() == app->thread();
+    if (!mainThread && !threadGuards().hasLocalData()) {
+        threadGuards().setLocalData(new ThreadConnectionGuard{ this });
+    }
+
+    if (!openConnection(connection.name)) {
+        releaseThreadConnection();
+        return QSqlDatabase();
+    }
+    return QSqlDatabase::database(connection.name, false);
+}
+
+QSqlQuery DatabaseManager::preparedQuery(const QString& sql) {
+    QSqlDatabase db = database();
+    if (!db.isValid()) {
+        return QSqlQuery(db);
+    }
+
+    const Qt::HANDLE thread = QThread::currentThreadId();
+    QMutexLocker locker(&m_mutex);
+    auto it = m_connections.find(thread);
+    if (it != m_connections.end()) {
+        const auto cached = it->statements.constFind(sql);
+        if (cached != it->statements.constEnd()) {
+            QSqlQuery query = *cached;
+            locker.unlock();
+            query.finish(); // Освобождаем результат предыдущего выполнения
+            return query;
+        }
+    }
+    locker.unlock();
+
+    // Подготовка идет без блокировки: кэш потока меняет только сам поток
+    QSqlQuery query(db);
+    if (!query.prepare(sql)) {
+        qWarning() << "Failed to prepare statement:" << query.lastError().text();
+        return query;
+    }
+
+    locker.relock();
+    it = m_connections.find(thread);
+    if (it != m_connections.end()) {
+        it->statements.insert(sql, query);
+    }
+    return query;
+}
+
+void DatabaseManager::clearStatements() {
+    QHash<QString, QSqlQuery> statements;
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_connections.find(QThread::currentThreadId());
+        if (it != m_connections.end()) {
+            statements.swap(it->statements);
+        }
+    }
+    // Запросы уничтожаются вне блокировки: QPSQL освобождает их на сервере
+    statements.clear();
+}
+
+void DatabaseManager::releaseThreadConnection() {
+    clearStatements();
+
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_connections.find(QThread::currentThreadId());
+    if (it == m_connections.end()) {
+        return;
+    }
+    const QString name = it->name;
+    m_connections.erase(it);
+    locker.unlock();
+
+    {
+        QSqlDatabase db = QSqlDatabase::database(name, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+    m_connectionReleased.wakeOne();
+}
+
+QThreadPool* DatabaseManager::workerPool() {
+    return &m_workers;
+}
+
+int DatabaseManager::connectionCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_connections.size();
+}
+
+bool DatabaseManager::openConnection(const QString& name) {
+    const DatabaseConfig& config = DatabaseConfig::instance();
+    QSqlDatabase db = QSqlDatabase::addDatabase("QPSQL", name);
+
+    // Настройка параметров подключения из конфигурации
+    db.setHostName(config.hostName());
+    db.setDatabaseName(config.databaseName());
+    db.setUserName(config.userName());
+    db.setPassword(config.password());
+    db.setPort(config.port());
+
+    if (!db.open()) {
+        qCritical() << "Failed to connect to database:" << db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::ensureAlive(QSqlDatabase& db) {
+    if (db.isOpen()) {
+        QSqlQuery ping(db);
+        if (ping.exec("SELECT 1")) {
+            return true;
+        }
+        qWarning() << "Database connection" << db.connectionName() << "is broken:" << ping.lastError().text();
+    }
+
+    // Подготовленные запросы принадлежат старому серверному сеансу
+    clearStatements();
+    db.close();
+
+    if (!db.open()) {
+        qCritical() << "Failed to reopen database connection:" << db.lastError().text();
+        return false;
+    }
+    qDebug() << "Database connection" << db.connectionName() << "reopened";
+    return true;
+}
+
+void DatabaseManager::warmUp(int count) {
+    count = qMin(count, m_workers.maxThreadCount());
+    if (count <= 0) {
+        return;
+    }
+
+    // Задачи ждут друг друга, чтобы каждая заняла отдельный поток пула
+    struct Barrier {
+        QAtomicInt remaining;
+        QSemaphore arrived;
+    };
+    QSharedPointer<Barrier> barrier = QSharedPointer<Barrier>::create();
+    barrier->remaining.storeRelaxed(count);
+
+    for (int i = 0; i < count; ++i) {
+        m_workers.start([this, barrier, count]() {
+            database();
+            if (barrier->remaining.fetchAndAddOrdered(-1) == 1) {
+                barrier->arrived.release(count);
+            }
+            barrier->arrived.tryAcquire(1, DatabaseConfig::instance().acquireTimeout());
+        });
+    }
 }
 
 bool DatabaseManager::createTables() {
-    QSqlQuery query(m_database);
+    QSqlQuery query(database());
 
     // Создание таблицы users согласно ТЗ
     QString createUsersTable = R"(
@@ -133,7 +346,7 @@ bool DatabaseManager::createTables() {
 }
 
 bool DatabaseManager::seedData() {
-    QSqlQuery query(m_database);
+    QSqlQuery query(database());
 
     // Проверяем, пуста ли таблица users
     if (!query.exec("SELECT COUNT(*) FROM users")) {
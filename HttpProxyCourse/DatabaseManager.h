@@ -4,14 +4,30 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QString>
+#include <QHash>
 #include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <atomic>
 #include "DatabaseConfig.h"
 
 /**
  * @brief Singleton класс для управления подключением к базе данных PostgreSQL.
  * 
- * Обеспечивает единое подключение к БД и инициализацию схемы.
+ * Обеспечивает подключение к БД и инициализацию схемы.
  * Использует драйвер QPSQL для работы с PostgreSQL.
+ *
+ * QSqlDatabase нельзя использовать из потока, который его не создавал,
+ * поэтому database() выдает каждому потоку собственное именованное
+ * соединение из пула. Размер пула ограничивает число потоков, одновременно
+ * работающих с БД: поток сверх предела ждет освобождения соединения.
+ * Соединение, простоявшее дольше DatabaseConfig::checkInterval(), перед
+ * выдачей проверяется запросом и при обрыве открывается заново.
+ *
+ * Для фоновой работы с БД предназначен workerPool(): его потоки завершаются
+ * после DatabaseConfig::idleTimeout() простоя и при этом закрывают свои
+ * соединения, а при запуске часть из них открывает соединения заранее.
  */
 class DatabaseManager {
 public:
@@ -41,10 +57,48 @@ public:
     bool isConnected() const;
 
     /**
-     * @brief Получить объект базы данных для выполнения запросов.
-     * @return Ссылка на QSqlDatabase.
+     * @brief Получить соединение текущего потока для выполнения запросов.
+     *
+     * При первом обращении потока соединение открывается (если пул заполнен —
+     * после ожидания не дольше DatabaseConfig::acquireTimeout()).
+     *
+     * @return Соединение потока; недействительный QSqlDatabase, если БД не
+     *         подключена или свободного места в пуле не появилось.
      */
-    QSqlDatabase& database();
+    QSqlDatabase database();
+
+    /**
+     * @brief Получить подготовленный запрос соединения текущего потока.
+     *
+     * Запросы кэшируются по тексту SQL отдельно для каждого соединения пула,
+     * поэтому сервер разбирает и планирует каждый текст один раз на соединение.
+     * Возвращаемый QSqlQuery разделяет результат с кэшем: он действителен до
+     * следующего вызова с тем же текстом в этом потоке, поэтому вложенно
+     * использовать один и тот же текст нельзя. Кэш очищается при переоткрытии
+     * и освобождении соединения. Запросы с изменяемым текстом сюда не передаются.
+     *
+     * @param sql Текст запроса с позиционными параметрами.
+     * @return Подготовленный запрос; при ошибке подготовки — запрос, exec()
+     *         которого вернет false с описанием ошибки.
+     */
+    QSqlQuery preparedQuery(const QString& sql);
+
+    /**
+     * @brief Закрыть соединение текущего потока и вернуть место в пул.
+     * Потоки workerPool() и другие потоки QThread делают это при завершении сами.
+     */
+    void releaseThreadConnection();
+
+    /**
+     * @brief Получить пул потоков для фоновой работы с БД.
+     * @return Пул, размер которого согласован с пулом соединений.
+     */
+    QThreadPool* workerPool();
+
+    /**
+     * @brief Получить число открытых соединений пула.
+     */
+    int connectionCount() const;
 
     /**
      * @brief Деструктор. Закрывает соединение с БД.
@@ -63,6 +117,41 @@ private:
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
 
+    /**
+     * @brief Соединение пула, закрепленное за потоком.
+     */
+    struct PooledConnection {
+        QString name;        ///< Имя соединения в QSqlDatabase
+        qint64 lastUsed = 0; ///< Время последней выдачи (мс от запуска пула)
+        QHash<QString, QSqlQuery> statements; ///< Подготовленные запросы по тексту SQL
+    };
+
+    /**
+     * @brief Открыть соединение с параметрами из DatabaseConfig.
+     * @param name Имя соединения.
+     * @return true, если соединение открыто.
+     */
+    bool openConnection(const QString& name);
+
+    /**
+     * @brief Проверить, что сервер отвечает, и при обрыве переоткрыть соединение.
+     * @param db Соединение текущего потока.
+     * @return true, если соединение работоспособно.
+     */
+    bool ensureAlive(QSqlDatabase& db);
+
+    /**
+     * @brief Удалить подготовленные запросы соединения текущего потока.
+     * Вызывается до закрытия соединения, пока сервер еще может их освободить.
+     */
+    void clearStatements();
+
+    /**
+     * @brief Открыть соединения в потоках workerPool() заранее.
+     * @param count Число соединений.
+     */
+    void warmUp(int count);
+
     /**
      * @brief Создать таблицы в базе данных.
      * @return true, если таблицы созданы успешно.
@@ -82,7 +171,11 @@ private:
      */
     QString calculateSha256(const QString& input) const;
 
-    QSqlDatabase m_database;    ///< Объект подключения к БД
-    QMutex m_mutex;            ///< Мьютекс для потокобезопасности
-    bool m_connected;          ///< Флаг состояния подключения
+    mutable QMutex m_mutex;                          ///< Мьютекс для потокобезопасности
+    QWaitCondition m_connectionReleased;             ///< Освобождение места в пуле
+    QHash<Qt::HANDLE, PooledConnection> m_connections; ///< Соединения по потокам
+    QElapsedTimer m_clock;                           ///< Часы простоя соединений
+    int m_nextConnectionId;                          ///< Счетчик имен соединений
+    std::atomic<bool> m_connected;                   ///< Флаг состояния подключения
+    QThreadPool m_workers;                           ///< Потоки фоновой работы с БД (удаляются первыми)
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "DatabaseManager.h"
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QtConcurrent>
+#include <utility>
+
+/**
+ * @brief Выполнение запросов к БД вне потока интерфейса.
+ *
+ * run() ставит функцию в DatabaseManager::workerPool(): каждый поток пула
+ * работает через собственное соединение, поэтому синхронные методы DAO
+ * вызываются из задачи без изменений. then() доставляет результат в поток
+ * объекта-получателя; если получатель удален раньше, продолжение не вызывается.
+ *
+ * Пример:
+ * @code
+ * DbExecutor::then(this, UserDao::findByLoginAsync(login), [this](const User& user) {
+ *     showUser(user);
+ * });
+ * @endcode
+ */
+class DbExecutor {
+public:
+    /**
+     * @brief Выполняет функцию в пуле потоков БД.
+     * @param function Функция без аргументов; результат становится результатом QFuture.
+     * @return Future с результатом функции.
+     */
+    template <typename Function>
+    static auto run(Function function) -> QFuture<decltype(function())> {
+        return QtConcurrent::run(DatabaseManager::instance().workerPool(), std::move(function));
+    }
+
+    /**
+     * @brief Вызывает продолжение с результатом future в потоке получателя.
+     * @param context Получатель; продолжение выполняется в его потоке и только пока он жив.
+     * @param future Future, результат которого ожидается.
+     * @param continuation Функция, принимающая результат.
+     */
+    template <typename T, typename Continuation>
+    static void then(QObject* context, const QFuture<T>& future, Continuation continuation) {
+        auto* watcher = new QFutureWatcher<T>(context);
+        QObject::connect(watcher, &QFutureWatcher<T>::finished, context,
+                         [watcher, continuation = std::move(continuation)]() {
+                             continuation(watcher->result());
+                             watcher->deleteLater();
+                         });
+        watcher->setFuture(future);
+    }
+};
@@ -0,0 +1,157 @@
+#include "DefaultCourse.h"
+#include <iterator>
+
+namespace {
+/// @brief Максимальное количество вариантов ответа во встроенных вопросах.
+constexpr int MaxVariants = 4;
+
+/**
+ * @brief Вопрос встроенного курса; строки лежат в секции констант исполняемого файла.
+ */
+struct QuestionData {
+    QStringView text;
+    QStringView variants[MaxVariants];
+    qint32 correctIndex;
+};
+
+/**
+ * @brief Тема встроенного курса.
+ */
+struct TopicData {
+    QStringView title;
+    QStringView htmlContent;
+    const QuestionData* questions;
+    int questionCount;
+};
+
+// Тема 1: Введение в HTTP Proxy
+constexpr QStringView Topic1Html = uR"(
+        <h2>HTTP Прокси-сервер</h2>
+        <p><b>HTTP Прокси-сервер</b> — это промежуточный узел (посредник) в компьютерной сети, который выступает в роли шлюза между пользователем (клиентом) и интернетом (целевым сервером).</p>
+        
+        <h3>Типы прокси-серверов:</h3>
+        <ul>
+            <li><b>Forward Proxy (Прямой прокси):</b> Работает в интересах клиента. Обычно используется для обхода ограничений доступа, сокрытия реального IP-адреса пользователя или контроля исходящего трафика в корпоративных сетях.</li>
+            <li><b>Reverse Proxy (Обратный прокси):</b> Работает в интересах сервера. Он принимает запросы из интернета и передает их на внутренние серверы, обеспечивая защиту от атак, балансировку нагрузки и SSL-шифрование.</li>
+        </ul>
+        
+        <h3>Преимущества использования прокси:</h3>
+        <ul>
+            <li><b>Кэширование:</b> Сохранение копий часто запрашиваемых ресурсов для ускорения загрузки и экономии трафика.</li>
+            <li><b>Анонимность:</b> Сокрытие информации о клиенте от целевого ресурса.</li>
+            <li><b>Фильтрация и контроль:</b> Блокировка нежелательных сайтов, рекламы или вредоносного ПО.</li>
+        </ul>
+    )";
+
+constexpr QuestionData Topic1Questions[] = {
+    {
+        u"Какое определение наиболее точно описывает роль HTTP прокси-сервера?",
+        {
+            u"Это база данных для хранения учетных записей пользователей.",
+            u"Это посредник между клиентом и сервером, пересылающий запросы и ответы.",
+            u"Это протокол для прямой передачи файлов между компьютерами.",
+            u"Это антивирусная программа для защиты рабочего стола."
+        },
+        1
+    },
+    {
+        u"В чем заключается основная функция Reverse Proxy (Обратного прокси)?",
+        {
+            u"Защита внутренних серверов и распределение нагрузки (балансировка).",
+            u"Помощь пользователю в обходе блокировок провайдера.",
+            u"Ускорение работы локальной сети принтеров.",
+            u"Генерация паролей для администраторов."
+        },
+        0
+    },
+    {
+        u"Какой механизм прокси-сервера позволяет уменьшить потребление трафика и ускорить загрузку страниц?",
+        {
+            u"Шифрование данных (SSL).",
+            u"Кэширование часто запрашиваемых ресурсов.",
+            u"Фильтрация вредоносного ПО.",
+            u"Балансировка нагрузки между серверами."
+        },
+        1
+    }
+};
+
+// Тема 2: Настройка и конфигурация
+constexpr QStringView Topic2Html = uR"(
+        <h2>Настройка HTTP Proxy</h2>
+        <p>Правильная настройка прокси-сервера критически важна для обеспечения безопасности и производительности сети.</p>
+        
+        <h3>Основные параметры конфигурации:</h3>
+        <ul>
+            <li><b>Порт прослушивания:</b> Обычно 8080, 3128 или 8888</li>
+            <li><b>Методы аутентификации:</b> Basic, Digest, NTLM</li>
+            <li><b>Правила доступа:</b> ACL (Access Control Lists)</li>
+            <li><b>Логирование:</b> Детальная запись всех запросов</li>
+        </ul>
+        
+        <h3>Безопасность:</h3>
+        <p>Важно настроить фильтрацию по IP-адресам, доменам и типам контента для предотвращения несанкционированного доступа.</p>
+    )";
+
+constexpr QuestionData Topic2Questions[] = {
+    {
+        u"Какой порт чаще всего используется для HTTP прокси-серверов?",
+        {
+            u"80",
+            u"443",
+            u"8080",
+            u"22"
+        },
+        2
+    },
+    {
+        u"Что такое ACL в контексте прокси-серверов?",
+        {
+            u"Automatic Cache Loading",
+            u"Access Control Lists (Списки контроля доступа)",
+            u"Advanced Connection Logic",
+            u"Anonymous Client Login"
+        },
+        1
+    }
+};
+
+constexpr TopicData Topics[] = {
+    { u"Введение в HTTP Proxy", Topic1Html, Topic1Questions, int(std::size(Topic1Questions)) },
+    { u"Настройка и конфигурация HTTP Proxy", Topic2Html, Topic2Questions, int(std::size(Topic2Questions)) }
+};
+
+/**
+ * @brief Создает QString поверх статической строки без копирования.
+ */
+QString staticString(QStringView text) {
+    return QString::fromRawData(reinterpret_cast<const QChar*>(text.utf16()), int(text.size()));
+}
+
+} // namespace
+
+Course DefaultCourse::create() {
+    Course course;
+    course.topics.reserve(int(std::size(Topics)));
+
+    for (const TopicData& data : Topics) {
+        Topic topic;
+        topic.title = staticString(data.title);
+        topic.htmlContent = staticString(data.htmlContent);
+
+        for (int i = 0; i < data.questionCount; ++i) {
+            const QuestionData& questionData = data.questions[i];
+            Question question;
+            question.text = staticString(questionData.text);
+            for (QStringView variant : questionData.variants) {
+                if (!variant.isEmpty()) {
+                    question.variants << staticString(variant);
+                }
+            }
+            question.correctIndex = questionData.correctIndex;
+            topic.questions << question;
+        }
+        course.topics << topic;
+    }
+    return course;
+}
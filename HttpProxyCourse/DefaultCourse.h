@@ -0,0 +1,24 @@
+#pragma once
+
+#include "DomainTypes.h"
+
+/**
+ * @brief Встроенный курс по умолчанию.
+ *
+ * Содержимое курса хранится в исполняемом файле в виде constexpr-таблицы
+ * строковых литералов и не требует ни чтения, ни записи course.dat.
+ * Используется при первом запуске и как резервный вариант, если файл
+ * курса отсутствует или поврежден.
+ */
+class DefaultCourse {
+public:
+    /**
+     * @brief Создает встроенный курс.
+     *
+     * Строки курса ссылаются на данные исполняемого файла без копирования
+     * (QString::fromRawData); все темы сразу считаются загруженными.
+     *
+     * @return Курс без привязки к файлу (storage == nullptr).
+     */
+    static Course create();
+};
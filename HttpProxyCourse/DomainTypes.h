@@ -4,8 +4,11 @@
 #include <QStringList>
 #include <QList>
 #include <QDataStream>
+#include <QSharedPointer>
 #include <QDebug>
 
+class CourseStorage;
+
 /**
  * @brief Структура пользователя системы.
  */
@@ -56,10 +59,52 @@ struct Question {
 
     /// @brief Индекс правильного ответа (0-based).
     /// @note Должен быть в диапазоне [0, variants.size() - 1].
-    qint32 correctIndex;
+    qint32 correctIndex = 0;
+
+    /**
+     * @brief Результат проверки вопроса после десериализации.
+     */
+    enum class Validity {
+        Valid,               ///< Данные корректны
+        EmptyVariants,       ///< Пустой список вариантов заменен на "Да"/"Нет"
+        InvalidCorrectIndex  ///< correctIndex вне границ сброшен в 0
+    };
+
+    /**
+     * @brief Исправляет некорректные данные вопроса после десериализации.
+     *
+     * Пустой список вариантов заменяется вариантами "Да"/"Нет",
+     * а correctIndex вне допустимых границ сбрасывается в 0.
+     * Сам метод ничего не пишет в журнал: результаты собирает ValidationReport.
+     *
+     * @return Что было исправлено.
+     */
+    Validity sanitize() {
+        // Проверяем, что variants не пуст и correctIndex в допустимых границах
+        if (variants.isEmpty()) {
+            // Статические строки: вставленные варианты не выделяют память
+            variants << QStringLiteral("Да") << QStringLiteral("Нет");
+            correctIndex = 0;
+            return Validity::EmptyVariants;
+        }
+        if (correctIndex < 0 || correctIndex >= variants.size()) {
+            correctIndex = 0; // Устанавливаем безопасное значение по умолчанию
+            return Validity::InvalidCorrectIndex;
+        }
+        return Validity::Valid;
+    }
 
     /**
-     * @brief Оператор записи в QDataStream.
+     * @brief Сравнивает вопросы по тексту, вариантам и правильному ответу.
+     */
+    bool operator==(const Question& other) const {
+        return correctIndex == other.correctIndex && text == other.text && variants == other.variants;
+    }
+
+    bool operator!=(const Question& other) const { return !(*this == other); }
+
+    /**
+     * @brief Оператор записи в QDataStream (формат v1).
      * @param out Поток вывода.
      * @param q Объект вопроса.
      */
@@ -69,7 +114,7 @@ struct Question {
     }
 
     /**
-     * @brief Оператор чтения из QDataStream.
+     * @brief Оператор чтения из QDataStream (формат v1).
      * @param in Поток ввода.
      * @param q Объект вопроса для заполнения.
      */
@@ -77,21 +122,81 @@ struct Question {
         in >> q.text >> q.variants >> q.correctIndex;
         
         // Критическая валидация после десериализации
-        // Проверяем, что variants не пуст и correctIndex в допустимых границах
-        if (q.variants.isEmpty()) {
+        const qint32 originalIndex = q.correctIndex;
+        switch (q.sanitize()) {
+        case Validity::EmptyVariants:
             qWarning() << "Question deserialization: empty variants list, adding default options";
-            q.variants << "Да" << "Нет";
-            q.correctIndex = 0;
-        } else if (q.correctIndex < 0 || q.correctIndex >= q.variants.size()) {
-            qWarning() << "Question deserialization: invalid correctIndex" << q.correctIndex 
+            break;
+        case Validity::InvalidCorrectIndex:
+            qWarning() << "Question deserialization: invalid correctIndex" << originalIndex
                       << "for" << q.variants.size() << "variants, reset to 0";
-            q.correctIndex = 0; // Устанавливаем безопасное значение по умолчанию
+            break;
+        case Validity::Valid:
+            break;
         }
         
         return in;
     }
 };
 
+/**
+ * @brief Сводка проверки вопросов, собранная при декодировании тем.
+ *
+ * Заменяет отдельное предупреждение на каждый некорректный вопрос:
+ * отчеты потоков объединяются через merge() и выводятся одной строкой.
+ */
+struct ValidationReport {
+    int topicsChecked = 0;         ///< Количество декодированных тем
+    int questionsChecked = 0;      ///< Количество проверенных вопросов
+    int emptyVariants = 0;         ///< Вопросы с пустым списком вариантов
+    int invalidCorrectIndex = 0;   ///< Вопросы с correctIndex вне границ
+    QStringList failedTopics;      ///< Темы, которые не удалось декодировать (с причиной)
+
+    /**
+     * @brief Учитывает результат проверки одного вопроса.
+     */
+    void record(Question::Validity validity) {
+        ++questionsChecked;
+        if (validity == Question::Validity::EmptyVariants) {
+            ++emptyVariants;
+        } else if (validity == Question::Validity::InvalidCorrectIndex) {
+            ++invalidCorrectIndex;
+        }
+    }
+
+    /**
+     * @brief Добавляет к сводке результаты другого отчета.
+     */
+    void merge(const ValidationReport& other) {
+        topicsChecked += other.topicsChecked;
+        questionsChecked += other.questionsChecked;
+        emptyVariants += other.emptyVariants;
+        invalidCorrectIndex += other.invalidCorrectIndex;
+        failedTopics += other.failedTopics;
+    }
+
+    /**
+     * @brief Проверяет, что исправлений и ошибок не было.
+     */
+    bool isClean() const {
+        return emptyVariants == 0 && invalidCorrectIndex == 0 && failedTopics.isEmpty();
+    }
+
+    /**
+     * @brief Возвращает сводку одной строкой для журнала.
+     */
+    QString summary() const {
+        QString text = QString("%1 topics, %2 questions checked: %3 with empty variants, "
+                               "%4 with invalid correctIndex, %5 topics failed")
+                           .arg(topicsChecked).arg(questionsChecked)
+                           .arg(emptyVariants).arg(invalidCorrectIndex).arg(failedTopics.size());
+        if (!failedTopics.isEmpty()) {
+            text += " (" + failedTopics.join("; ") + ")";
+        }
+        return text;
+    }
+};
+
 /**
  * @brief Структура темы обучения.
  * Содержит теоретический материал и список вопросов для самопроверки.
@@ -106,6 +211,15 @@ struct Topic {
     /// @brief Список вопросов по данной теме.
     QList<Question> questions;
 
+    /// @brief Индекс блока темы в контейнере course.dat v2, пока теория и вопросы не загружены.
+    /// @note -1 означает, что тело темы уже находится в памяти.
+    qint32 storageIndex = -1;
+
+    /**
+     * @brief Проверяет, загружены ли теория и вопросы темы.
+     */
+    bool isBodyLoaded() const { return storageIndex < 0; }
+
     friend QDataStream& operator<<(QDataStream& out, const Topic& t) {
         out << t.title << t.htmlContent << t.questions;
         return out;
@@ -117,6 +231,9 @@ struct Topic {
     }
 };
 
+/// @brief Разделяемая неизменяемая тема (элемент снимка SharedCourse).
+using TopicPtr = QSharedPointer<const Topic>;
+
 /**
  * @brief Корневая структура курса.
  * Содержит упорядоченный список всех тем.
@@ -125,6 +242,10 @@ struct Course {
     /// @brief Список тем курса.
     QList<Topic> topics;
 
+    /// @brief Отображенный в память файл курса, из которого подгружаются тела тем.
+    /// @note Пуст, если курс загружен целиком (формат v1 или создан в коде).
+    QSharedPointer<CourseStorage> storage;
+
     friend QDataStream& operator<<(QDataStream& out, const Course& c) {
         out << c.topics;
         return out;
@@ -0,0 +1,336 @@
+#include "HtmlMinifier.h"
+#include <QSet>
+
+namespace {
+
+/**
+ * @brief Теги, поддерживаемые Qt Rich Text (QTextDocument/QTextBrowser).
+ */
+const QSet<QString>& supportedTags() {
+    static const QSet<QString> tags = {
+        "a", "address", "b", "big", "blockquote", "body", "br", "center", "cite", "code",
+        "dd", "dfn", "div", "dl", "dt", "em", "font", "h1", "h2", "h3", "h4", "h5", "h6",
+        "head", "hr", "html", "i", "img", "kbd", "li", "meta", "nobr", "ol", "p", "pre",
+        "qt", "s", "samp", "small", "span", "strong", "style", "sub", "sup", "table",
+        "tbody", "td", "tfoot", "th", "thead", "title", "tr", "tt", "u", "ul", "var"
+    };
+    return tags;
+}
+
+/**
+ * @brief Блочные элементы: пробелы на их границах не отображаются.
+ */
+const QSet<QString>& blockTags() {
+    static const QSet<QString> tags = {
+        "address", "blockquote", "body", "br", "center", "dd", "div", "dl", "dt",
+        "h1", "h2", "h3", "h4", "h5", "h6", "head", "hr", "html", "li", "meta", "ol",
+        "p", "pre", "qt", "style", "table", "tbody", "td", "tfoot", "th", "thead",
+        "title", "tr", "ul"
+    };
+    return tags;
+}
+
+/**
+ * @brief Элементы, которые удаляются вместе с содержимым.
+ */
+const QSet<QString>& droppedTags() {
+    static const QSet<QString> tags = {
+        "applet", "audio", "canvas", "embed", "iframe", "noscript", "object", "script",
+        "svg", "template", "video"
+    };
+    return tags;
+}
+
+/**
+ * @brief Пробельные символы HTML (в отличие от QChar::isSpace() без неразрывного пробела).
+ */
+bool isHtmlSpace(QChar c) {
+    return c == QLatin1Char(' ') || c == QLatin1Char('\n') || c == QLatin1Char('\t')
+           || c == QLatin1Char('\r') || c == QLatin1Char('\f');
+}
+
+bool isNameChar(QChar c) {
+    return (c >= QLatin1Char('a') && c <= QLatin1Char('z')) || (c >= QLatin1Char('A') && c <= QLatin1Char('Z'))
+           || (c >= QLatin1Char('0') && c <= QLatin1Char('9')) || c == QLatin1Char('-') || c == QLatin1Char(':')
+           || c == QLatin1Char('_');
+}
+
+/**
+ * @brief Проверяет без учета регистра, начинается ли текст в позиции pos с ASCII-строки.
+ */
+bool matchesAt(const QChar* data, int size, int pos, const char* text) {
+    for (; *text; ++text, ++pos) {
+        if (pos >= size || data[pos].toLower() != QLatin1Char(*text)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Возвращает позицию сразу за первым вхождением text (без учета регистра) или size.
+ */
+int skipPast(const QChar* data, int size, int pos, const char* text) {
+    const int length = static_cast<int>(qstrlen(text));
+    for (; pos + length <= size; ++pos) {
+        if (matchesAt(data, size, pos, text)) {
+            return pos + length;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Разобранный тег.
+ */
+struct Tag {
+    QString name;           ///< Имя в нижнем регистре
+    QString attributes;     ///< Нормализованные атрибуты (с ведущими пробелами)
+    bool closing = false;   ///< </tag>
+    bool selfClosing = false;  ///< <tag/>
+};
+
+/**
+ * @brief Проверяет, безопасен ли атрибут для сохранения.
+ */
+bool isSafeAttribute(const QString& name, const QString& value) {
+    if (name.startsWith(QLatin1String("on"))) {
+        return false;
+    }
+    if (name == QLatin1String("href") || name == QLatin1String("src")) {
+        return !value.trimmed().startsWith(QLatin1String("javascript:"), Qt::CaseInsensitive);
+    }
+    return true;
+}
+
+/**
+ * @brief Разбирает тег, начинающийся с '<' в позиции pos.
+ * @return Позиция сразу за тегом.
+ */
+int parseTag(const QChar* data, int size, int pos, Tag& tag) {
+    ++pos;  // '<'
+    if (pos < size && data[pos] == QLatin1Char('/')) {
+        tag.closing = true;
+        ++pos;
+    }
+    while (pos < size && isNameChar(data[pos])) {
+        tag.name.append(data[pos].toLower());
+        ++pos;
+    }
+
+    for (;;) {
+        while (pos < size && isHtmlSpace(data[pos])) {
+            ++pos;
+        }
+        if (pos >= size) {
+            return size;
+        }
+        if (data[pos] == QLatin1Char('>')) {
+            return pos + 1;
+        }
+        if (data[pos] == QLatin1Char('/')) {
+            tag.selfClosing = true;
+            ++pos;
+            continue;
+        }
+
+        // Атрибут: имя[=значение], значение в кавычках или без них
+        QString name;
+        while (pos < size && !isHtmlSpace(data[pos]) && data[pos] != QLatin1Char('=')
+               && data[pos] != QLatin1Char('>') && data[pos] != QLatin1Char('/')) {
+            name.append(data[pos].toLower());
+            ++pos;
+        }
+        if (name.isEmpty()) {
+            ++pos;  // Мусорный символ внутри тега
+            continue;
+        }
+
+        int look = pos;
+        while (look < size && isHtmlSpace(data[look])) {
+            ++look;
+        }
+        if (look >= size || data[look] != QLatin1Char('=')) {
+            tag.attributes += QLatin1Char(' ') + name;
+            continue;
+        }
+
+        pos = look + 1;
+        while (pos < size && isHtmlSpace(data[pos])) {
+            ++pos;
+        }
+
+        QString value;
+        QChar quote = QLatin1Char('"');
+        if (pos < size && (data[pos] == QLatin1Char('"') || data[pos] == QLatin1Char('\''))) {
+            quote = data[pos++];
+            const int begin = pos;
+            while (pos < size && data[pos] != quote) {
+                ++pos;
+            }
+            value = QString(data + begin, pos - begin);
+            if (pos < size) {
+                ++pos;
+            }
+        } else {
+            const int begin = pos;
+            while (pos < size && !isHtmlSpace(data[pos]) && data[pos] != QLatin1Char('>')) {
+                ++pos;
+            }
+            value = QString(data + begin, pos - begin);
+            if (value.contains(QLatin1Char('"'))) {
+                quote = QLatin1Char('\'');
+            }
+        }
+
+        if (isSafeAttribute(name, value)) {
+            tag.attributes += QLatin1Char(' ') + name + QLatin1Char('=') + quote + value + quote;
+        }
+    }
+}
+
+/**
+ * @brief Сборка результата со сворачиванием пробелов.
+ */
+class Output {
+public:
+    explicit Output(int capacity) { m_html.reserve(capacity); }
+
+    void text(const QChar* data, int length) {
+        for (int i = 0; i < length; ++i) {
+            const QChar c = data[i];
+            if (m_preDepth > 0) {
+                m_html.append(c);
+                continue;
+            }
+            if (isHtmlSpace(c)) {
+                m_pendingSpace = !m_atBlockBoundary;
+                continue;
+            }
+            flushSpace();
+            m_html.append(c);
+            m_atBlockBoundary = false;
+        }
+    }
+
+    void tag(const Tag& tag, bool block) {
+        if (block) {
+            // Пробел перед блочным элементом не отображается
+            m_pendingSpace = false;
+            m_atBlockBoundary = true;
+        } else {
+            flushSpace();
+        }
+
+        m_html += QLatin1Char('<');
+        if (tag.closing) {
+            m_html += QLatin1Char('/');
+        }
+        m_html += tag.name + tag.attributes;
+        if (tag.selfClosing) {
+            m_html += QLatin1Char('/');
+        }
+        m_html += QLatin1Char('>');
+
+        if (tag.name == QLatin1String("pre")) {
+            m_preDepth = qMax(0, m_preDepth + (tag.closing ? -1 : 1));
+        }
+    }
+
+    void raw(const QChar* data, int length) {
+        m_html.append(data, length);
+    }
+
+    QString take() { return m_html; }
+
+private:
+    void flushSpace() {
+        if (m_pendingSpace) {
+            m_html += QLatin1Char(' ');
+            m_pendingSpace = false;
+        }
+    }
+
+    QString m_html;
+    bool m_pendingSpace = false;
+    bool m_atBlockBoundary = true;
+    int m_preDepth = 0;
+};
+
+} // namespace
+
+HtmlMinifier::Result HtmlMinifier::minify(const QString& html) {
+    Result result;
+    const QChar* data = html.constData();
+    const int size = html.size();
+    Output out(size);
+
+    int pos = 0;
+    while (pos < size) {
+        if (data[pos] != QLatin1Char('<')) {
+            const int begin = pos;
+            while (pos < size && data[pos] != QLatin1Char('<')) {
+                ++pos;
+            }
+            out.text(data + begin, pos - begin);
+            continue;
+        }
+
+        // Комментарии, DOCTYPE и инструкции обработки
+        if (matchesAt(data, size, pos, "<!--")) {
+            pos = skipPast(data, size, pos + 4, "-->");
+            continue;
+        }
+        if (matchesAt(data, size, pos, "<!") || matchesAt(data, size, pos, "<?")) {
+            pos = skipPast(data, size, pos, ">");
+            continue;
+        }
+
+        // Одиночный '<', не начинающий тег, остается текстом
+        if (pos + 1 >= size || !(isNameChar(data[pos + 1]) || data[pos + 1] == QLatin1Char('/'))) {
+            out.text(data + pos, 1);
+            ++pos;
+            continue;
+        }
+
+        Tag tag;
+        pos = parseTag(data, size, pos, tag);
+        if (tag.name.isEmpty()) {
+            continue;
+        }
+
+        if (droppedTags().contains(tag.name)) {
+            if (!result.unsupportedTags.contains(tag.name)) {
+                result.unsupportedTags.append(tag.name);
+            }
+            if (!tag.closing && !tag.selfClosing) {
+                pos = skipPast(data, size, pos, QString("</" + tag.name).toLatin1().constData());
+                pos = skipPast(data, size, pos, ">");
+            }
+            continue;
+        }
+
+        if (!supportedTags().contains(tag.name)) {
+            if (!result.unsupportedTags.contains(tag.name)) {
+                result.unsupportedTags.append(tag.name);
+            }
+            continue;
+        }
+
+        out.tag(tag, blockTags().contains(tag.name));
+
+        // Таблица стилей переносится без изменений
+        if (tag.name == QLatin1String("style") && !tag.closing && !tag.selfClosing) {
+            const int begin = pos;
+            int end = begin;
+            while (end < size && !matchesAt(data, size, end, "</style")) {
+                ++end;
+            }
+            out.raw(data + begin, end - begin);
+            pos = end;
+        }
+    }
+
+    result.html = out.take();
+    return result;
+}
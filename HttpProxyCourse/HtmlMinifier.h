@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Нормализация HTML теории под подмножество, поддерживаемое QTextBrowser.
+ *
+ * Выполняется при сборке курса (CourseDataConverter), чтобы файл курса был
+ * меньше, а setHtml() в TopicViewWidget разбирал только значимую разметку:
+ * - удаляются комментарии, DOCTYPE и инструкции обработки;
+ * - последовательности пробельных символов сворачиваются в один пробел,
+ *   пробелы на границах блочных элементов удаляются (кроме &lt;pre&gt;);
+ * - имена тегов приводятся к нижнему регистру;
+ * - теги вне подмножества Qt Rich Text удаляются с сохранением текста,
+ *   а script, iframe, object и подобные — вместе с содержимым;
+ * - удаляются атрибуты-обработчики событий (on*) и ссылки javascript:.
+ */
+class HtmlMinifier {
+public:
+    /**
+     * @brief Результат нормализации.
+     */
+    struct Result {
+        QString html;                  ///< Нормализованный HTML
+        QStringList unsupportedTags;   ///< Удаленные неподдерживаемые теги (без повторов)
+    };
+
+    /**
+     * @brief Нормализует HTML одной темы.
+     * @param html Исходный HTML.
+     * @return Нормализованный HTML и список удаленных тегов.
+     */
+    static Result minify(const QString& html);
+};
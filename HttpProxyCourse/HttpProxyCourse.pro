@@ -1,4 +1,4 @@
-QT       += core gui sql
+QT       += core gui sql concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -11,22 +11,32 @@ CONFIG += moc
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Формат курса, сериализация и конвертер JSON (общие с tools/coursec)
+include(CourseCore.pri)
+
 SOURCES += \
     AdminWidget.cpp \
     AppController.cpp \
     AuthService.cpp \
-    CourseDataConverter.cpp \
+    CourseAssetCache.cpp \
     CourseModel.cpp \
+    CourseSearch.cpp \
     DatabaseConfig.cpp \
     DatabaseManager.cpp \
     Logger.cpp \
     LoginWidget.cpp \
     ProgressDao.cpp \
-    Serializer.cpp \
+    ProgressWriter.cpp \
+    SearchIndex.cpp \
     SessionManager.cpp \
+    SharedCourse.cpp \
     StudentProfileWidget.cpp \
     TestResultDao.cpp \
+    TestResultQueue.cpp \
     TestWidget.cpp \
+    TopicDocument.cpp \
+    TopicDocumentCache.cpp \
+    TopicListModel.cpp \
     TopicSelectionWidget.cpp \
     TopicViewWidget.cpp \
     UserDao.cpp \
@@ -37,19 +47,26 @@ HEADERS += \
     AdminWidget.h \
     AppController.h \
     AuthService.h \
-    CourseDataConverter.h \
+    CourseAssetCache.h \
     CourseModel.h \
+    CourseSearch.h \
     DatabaseConfig.h \
     DatabaseManager.h \
-    DomainTypes.h \
+    DbExecutor.h \
     Logger.h \
     LoginWidget.h \
     ProgressDao.h \
-    Serializer.h \
+    ProgressWriter.h \
+    SearchIndex.h \
     SessionManager.h \
+    SharedCourse.h \
     StudentProfileWidget.h \
     TestResultDao.h \
+    TestResultQueue.h \
     TestWidget.h \
+    TopicDocument.h \
+    TopicDocumentCache.h \
+    TopicListModel.h \
     TopicSelectionWidget.h \
     TopicViewWidget.h \
     UserDao.h \
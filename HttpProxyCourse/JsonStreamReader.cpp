@@ -0,0 +1,328 @@
+#include "JsonStreamReader.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Дописывает символ Unicode в буфер UTF-8.
+ */
+void appendUtf8(QByteArray& out, uint codePoint) {
+    if (codePoint < 0x80) {
+        out.append(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+} // namespace
+
+JsonStreamReader::JsonStreamReader(QIODevice* device)
+    : m_device(device)
+{
+}
+
+int JsonStreamReader::peek() {
+    if (m_pos == m_buffer.size()) {
+        if (m_capturing) {
+            m_capture.append(m_buffer.constData() + m_captureStart, m_buffer.size() - m_captureStart);
+            m_captureStart = 0;
+        }
+        m_consumed += m_buffer.size();
+        m_buffer = m_device->read(ChunkSize);
+        m_pos = 0;
+        if (m_buffer.isEmpty()) {
+            return -1;
+        }
+    }
+    return static_cast<uchar>(m_buffer[m_pos]);
+}
+
+int JsonStreamReader::skipWhitespace() {
+    int c = peek();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        ++m_pos;
+        c = peek();
+    }
+    return c;
+}
+
+JsonStreamReader::Token JsonStreamReader::next() {
+    int c = skipWhitespace();
+
+    switch (m_state) {
+    case State::Done:
+        if (c != -1) {
+            fail("unexpected data after the end of the document");
+        }
+        return Token::EndOfDocument;
+
+    case State::CommaOrEnd:
+        if (c == ',') {
+            ++m_pos;
+            m_state = m_stack.last() == '{' ? State::Name : State::Value;
+            c = skipWhitespace();
+            break;
+        }
+        if ((c == '}' && m_stack.last() == '{') || (c == ']' && m_stack.last() == '[')) {
+            break;
+        }
+        fail("expected ',' or a closing bracket");
+
+    case State::NameOrEnd:
+        if (c != '}') {
+            m_state = State::Name;
+        }
+        break;
+
+    case State::ValueOrEnd:
+        if (c != ']') {
+            m_state = State::Value;
+        }
+        break;
+
+    case State::Name:
+    case State::Value:
+        break;
+    }
+
+    // Закрывающая скобка допустима после значения или сразу после открывающей
+    if (m_state == State::CommaOrEnd || m_state == State::NameOrEnd || m_state == State::ValueOrEnd) {
+        ++m_pos;
+        const Token token = m_stack.last() == '{' ? Token::EndObject : Token::EndArray;
+        m_stack.removeLast();
+        finishValue();
+        return token;
+    }
+
+    if (m_state == State::Name) {
+        if (c != '"') {
+            fail("expected an object member name");
+        }
+        ++m_pos;
+        readString();
+        if (skipWhitespace() != ':') {
+            fail("expected ':' after an object member name");
+        }
+        ++m_pos;
+        m_state = State::Value;
+        return Token::Name;
+    }
+
+    switch (c) {
+    case '{':
+        ++m_pos;
+        m_stack.append('{');
+        m_state = State::NameOrEnd;
+        return Token::BeginObject;
+    case '[':
+        ++m_pos;
+        m_stack.append('[');
+        m_state = State::ValueOrEnd;
+        return Token::BeginArray;
+    case '"':
+        ++m_pos;
+        readString();
+        finishValue();
+        return Token::String;
+    case 't':
+        expectLiteral("true");
+        m_boolean = true;
+        finishValue();
+        return Token::Bool;
+    case 'f':
+        expectLiteral("false");
+        m_boolean = false;
+        finishValue();
+        return Token::Bool;
+    case 'n':
+        expectLiteral("null");
+        finishValue();
+        return Token::Null;
+    case -1:
+        fail("unexpected end of the document");
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            readNumber();
+            finishValue();
+            return Token::Number;
+        }
+        fail("unexpected character");
+    }
+}
+
+void JsonStreamReader::skipValue() {
+    const Token token = next();
+    if (token == Token::BeginObject || token == Token::BeginArray) {
+        skipToEnd();
+    } else if (token == Token::EndOfDocument) {
+        fail("unexpected end of the document");
+    }
+}
+
+void JsonStreamReader::skipToEnd() {
+    int depth = 1;
+    do {
+        switch (next()) {
+        case Token::BeginObject:
+        case Token::BeginArray:
+            ++depth;
+            break;
+        case Token::EndObject:
+        case Token::EndArray:
+            --depth;
+            break;
+        case Token::EndOfDocument:
+            fail("unexpected end of the document");
+        default:
+            break;
+        }
+    } while (depth > 0);
+}
+
+void JsonStreamReader::beginCapture() {
+    m_capturing = true;
+    m_captureStart = m_pos;
+    m_capture.clear();
+}
+
+QByteArray JsonStreamReader::endCapture() {
+    m_capture.append(m_buffer.constData() + m_captureStart, m_pos - m_captureStart);
+    m_capturing = false;
+    QByteArray captured;
+    captured.swap(m_capture);
+    return captured;
+}
+
+void JsonStreamReader::readString() {
+    m_utf8.clear();
+    for (;;) {
+        if (peek() == -1) {
+            fail("unterminated string");
+        }
+
+        // Быстрый путь: копируем участок блока до кавычки или обратной косой черты
+        const char* begin = m_buffer.constData() + m_pos;
+        const char* end = m_buffer.constData() + m_buffer.size();
+        const char* stop = begin;
+        while (stop != end && *stop != '"' && *stop != '\\') {
+            if (static_cast<uchar>(*stop) < 0x20) {
+                fail("control character in string");
+            }
+            ++stop;
+        }
+        m_utf8.append(begin, static_cast<int>(stop - begin));
+        m_pos += static_cast<int>(stop - begin);
+        if (stop == end) {
+            continue;
+        }
+
+        ++m_pos;
+        if (*stop == '"') {
+            break;
+        }
+
+        const int escape = peek();
+        ++m_pos;
+        switch (escape) {
+        case '"':  m_utf8.append('"'); break;
+        case '\\': m_utf8.append('\\'); break;
+        case '/':  m_utf8.append('/'); break;
+        case 'b':  m_utf8.append('\b'); break;
+        case 'f':  m_utf8.append('\f'); break;
+        case 'n':  m_utf8.append('\n'); break;
+        case 'r':  m_utf8.append('\r'); break;
+        case 't':  m_utf8.append('\t'); break;
+        case 'u': {
+            uint codePoint = readHex4();
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                // Суррогатная пара записывается двумя последовательностями \uXXXX
+                if (peek() != '\\') {
+                    fail("unpaired surrogate in string");
+                }
+                ++m_pos;
+                if (peek() != 'u') {
+                    fail("unpaired surrogate in string");
+                }
+                ++m_pos;
+                const uint low = readHex4();
+                if (low < 0xDC00 || low > 0xDFFF) {
+                    fail("unpaired surrogate in string");
+                }
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                fail("unpaired surrogate in string");
+            }
+            appendUtf8(m_utf8, codePoint);
+            break;
+        }
+        default:
+            fail("invalid escape sequence in string");
+        }
+    }
+    m_text = QString::fromUtf8(m_utf8);
+}
+
+uint JsonStreamReader::readHex4() {
+    uint value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int c = peek();
+        uint digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint>(c - 'A' + 10);
+        } else {
+            fail("invalid \\u escape sequence in string");
+        }
+        value = (value << 4) | digit;
+        ++m_pos;
+    }
+    return value;
+}
+
+void JsonStreamReader::readNumber() {
+    m_utf8.clear();
+    int c = peek();
+    while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9')) {
+        m_utf8.append(static_cast<char>(c));
+        ++m_pos;
+        c = peek();
+    }
+
+    bool ok = false;
+    m_number = m_utf8.toDouble(&ok);
+    if (!ok) {
+        fail("invalid number");
+    }
+}
+
+void JsonStreamReader::expectLiteral(const char* literal) {
+    for (const char* pos = literal; *pos; ++pos) {
+        if (peek() != static_cast<uchar>(*pos)) {
+            fail("invalid literal");
+        }
+        ++m_pos;
+    }
+}
+
+void JsonStreamReader::finishValue() {
+    m_state = m_stack.isEmpty() ? State::Done : State::CommaOrEnd;
+}
+
+void JsonStreamReader::fail(const char* reason) const {
+    throw std::runtime_error(std::string("Malformed JSON at byte ") + std::to_string(position()) + ": " + reason);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Потоковый (pull) разборщик JSON.
+ *
+ * Читает устройство блоками по ChunkSize байт и выдает документ по одному
+ * токену, не строя дерево QJsonDocument. В памяти одновременно находятся
+ * только текущий блок входных данных и значение текущего токена, поэтому
+ * объем памяти не зависит от размера файла.
+ */
+class JsonStreamReader {
+public:
+    /// @brief Размер блока чтения из устройства в байтах.
+    static constexpr int ChunkSize = 64 * 1024;
+
+    /**
+     * @brief Тип очередного токена.
+     */
+    enum class Token {
+        BeginObject,    ///< {
+        EndObject,      ///< }
+        BeginArray,     ///< [
+        EndArray,       ///< ]
+        Name,           ///< Имя поля объекта (значение — text())
+        String,         ///< Строка (значение — text())
+        Number,         ///< Число (значение — number())
+        Bool,           ///< true/false (значение — boolean())
+        Null,           ///< null
+        EndOfDocument   ///< Документ прочитан целиком
+    };
+
+    /**
+     * @brief Создает разборщик поверх открытого для чтения устройства.
+     * @param device Источник данных; должен жить, пока жив разборщик.
+     */
+    explicit JsonStreamReader(QIODevice* device);
+
+    JsonStreamReader(const JsonStreamReader&) = delete;
+    JsonStreamReader& operator=(const JsonStreamReader&) = delete;
+
+    /**
+     * @brief Читает следующий токен.
+     * @throws std::runtime_error Если документ не является корректным JSON.
+     */
+    Token next();
+
+    /**
+     * @brief Пропускает следующее значение целиком (вместе с вложенными объектами и массивами).
+     * @throws std::runtime_error Если документ не является корректным JSON.
+     */
+    void skipValue();
+
+    /**
+     * @brief Пропускает остаток объекта или массива, открывающий токен которого только что прочитан.
+     * @throws std::runtime_error Если документ не является корректным JSON.
+     */
+    void skipToEnd();
+
+    /**
+     * @brief Начинает запись исходных байтов документа с текущей позиции.
+     *
+     * Используется, чтобы получить исходный текст одного значения
+     * (например, для хеширования темы), не перечитывая файл.
+     */
+    void beginCapture();
+
+    /**
+     * @brief Завершает запись и возвращает байты от beginCapture() до текущей позиции.
+     */
+    QByteArray endCapture();
+
+    /**
+     * @brief Возвращает значение токена Name или String.
+     */
+    const QString& text() const { return m_text; }
+
+    /**
+     * @brief Возвращает значение токена Number.
+     */
+    double number() const { return m_number; }
+
+    /**
+     * @brief Возвращает значение токена Bool.
+     */
+    bool boolean() const { return m_boolean; }
+
+    /**
+     * @brief Возвращает смещение в байтах от начала документа (для сообщений об ошибках).
+     */
+    qint64 position() const { return m_consumed + m_pos; }
+
+private:
+    /**
+     * @brief Ожидаемый следующий элемент грамматики.
+     */
+    enum class State {
+        Value,          ///< Любое значение
+        ValueOrEnd,     ///< Значение или ] сразу после [
+        Name,           ///< Имя поля после запятой
+        NameOrEnd,      ///< Имя поля или } сразу после {
+        CommaOrEnd,     ///< Запятая или закрывающая скобка после значения
+        Done            ///< Корневое значение прочитано
+    };
+
+    /**
+     * @brief Возвращает текущий байт, подгружая блок при необходимости; -1 в конце данных.
+     */
+    int peek();
+
+    /**
+     * @brief Пропускает пробельные символы и возвращает следующий байт.
+     */
+    int skipWhitespace();
+
+    /**
+     * @brief Читает строку после открывающей кавычки в m_text.
+     */
+    void readString();
+
+    /**
+     * @brief Читает число в m_number.
+     */
+    void readNumber();
+
+    /**
+     * @brief Проверяет, что далее следует ключевое слово (true, false, null).
+     */
+    void expectLiteral(const char* literal);
+
+    /**
+     * @brief Читает четыре шестнадцатеричные цифры escape-последовательности \\u.
+     */
+    uint readHex4();
+
+    /**
+     * @brief Переводит разборщик в состояние после прочитанного значения.
+     */
+    void finishValue();
+
+    [[noreturn]] void fail(const char* reason) const;
+
+    QIODevice* m_device;        ///< Источник данных
+    QByteArray m_buffer;        ///< Текущий блок входных данных
+    int m_pos = 0;              ///< Позиция в текущем блоке
+    qint64 m_consumed = 0;      ///< Байт в ранее прочитанных блоках
+    QVector<char> m_stack;      ///< Открытые контейнеры: '{' или '['
+    State m_state = State::Value;
+    QByteArray m_utf8;          ///< Буфер UTF-8 текущей строки
+    QString m_text;             ///< Значение Name/String
+    double m_number = 0;        ///< Значение Number
+    bool m_boolean = false;     ///< Значение Bool
+    bool m_capturing = false;   ///< Идет запись исходных байтов
+    int m_captureStart = 0;     ///< Начало записи в текущем блоке
+    QByteArray m_capture;       ///< Байты записи из предыдущих блоков
+};
@@ -1,5 +1,6 @@
 #include "LoginWidget.h"
 #include "AuthService.h"
+#include "DbExecutor.h"
 #include <QFont>
 #include <QFormLayout>
 #include <QGridLayout>
@@ -133,6 +134,10 @@ QWidget* LoginWidget::createQuickAccessTab() {
 }
 
 void LoginWidget::onLoginClicked() {
+    if (!m_loginButton->isEnabled()) {
+        return; // Предыдущий запрос еще выполняется
+    }
+
     QString login = m_loginEdit->text().trimmed();
     QString password = m_passwordEdit->text();
     
@@ -140,29 +145,32 @@ void LoginWidget::onLoginClicked() {
         return;
     }
     
-    User user;
-    AuthService::AuthResult result = AuthService::login(login, password, user);
-    
-    switch (result) {
-        case AuthService::AuthResult::Success:
-            showSuccess(QString("Добро пожаловать, %1!").arg(user.fullName));
-            emit userAuthenticated(user);
-            break;
-            
-        case AuthService::AuthResult::UserNotFound:
-            showError("Пользователь не найден. Проверьте логин или зарегистрируйтесь.");
-            break;
-            
-        case AuthService::AuthResult::InvalidCredentials:
-            showError("Неверный пароль. Попробуйте еще раз.");
-            m_passwordEdit->clear();
-            m_passwordEdit->setFocus();
-            break;
-            
-        case AuthService::AuthResult::DatabaseError:
-            showError("Ошибка подключения к базе данных. Попробуйте позже.");
-            break;
-    }
+    // Ответ сервера приходит в продолжении, интерфейс при этом не блокируется
+    setBusy(true);
+    DbExecutor::then(this, AuthService::loginAsync(login, password),
+                     [this](const AuthService::LoginOutcome& outcome) {
+        setBusy(false);
+        switch (outcome.result) {
+            case AuthService::AuthResult::Success:
+                showSuccess(QString("Добро пожаловать, %1!").arg(outcome.user.fullName));
+                emit userAuthenticated(outcome.user);
+                break;
+
+            case AuthService::AuthResult::UserNotFound:
+                showError("Пользователь не найден. Проверьте логин или зарегистрируйтесь.");
+                break;
+
+            case AuthService::AuthResult::InvalidCredentials:
+                showError("Неверный пароль. Попробуйте еще раз.");
+                m_passwordEdit->clear();
+                m_passwordEdit->setFocus();
+                break;
+
+            case AuthService::AuthResult::DatabaseError:
+                showError("Ошибка подключения к базе данных. Попробуйте позже.");
+                break;
+        }
+    });
 }
 
 void LoginWidget::onRegisterClicked() {
@@ -174,30 +182,33 @@ void LoginWidget::onRegisterClicked() {
         return;
     }
     
-    AuthService::RegisterResult result = AuthService::registerUser(login, password, fullName, "student");
-    
-    switch (result) {
-        case AuthService::RegisterResult::Success:
-            showSuccess("Регистрация прошла успешно! Теперь вы можете войти в систему.");
-            m_regLoginEdit->clear();
-            m_regPasswordEdit->clear();
-            m_regFullNameEdit->clear();
-            m_tabWidget->setCurrentIndex(0); // Переключиться на вкладку входа
-            break;
-            
-        case AuthService::RegisterResult::UserExists:
-            showError("Пользователь с таким логином уже существует. Выберите другой логин.");
-            m_regLoginEdit->setFocus();
-            break;
-            
-        case AuthService::RegisterResult::InvalidInput:
-            showError("Некорректные данные. Проверьте заполнение всех полей.");
-            break;
-            
-        case AuthService::RegisterResult::DatabaseError:
-            showError("Ошибка базы данных. Попробуйте позже.");
-            break;
-    }
+    setBusy(true);
+    DbExecutor::then(this, AuthService::registerUserAsync(login, password, fullName, "student"),
+                     [this](AuthService::RegisterResult result) {
+        setBusy(false);
+        switch (result) {
+            case AuthService::RegisterResult::Success:
+                showSuccess("Регистрация прошла успешно! Теперь вы можете войти в систему.");
+                m_regLoginEdit->clear();
+                m_regPasswordEdit->clear();
+                m_regFullNameEdit->clear();
+                m_tabWidget->setCurrentIndex(0); // Переключиться на вкладку входа
+                break;
+
+            case AuthService::RegisterResult::UserExists:
+                showError("Пользователь с таким логином уже существует. Выберите другой логин.");
+                m_regLoginEdit->setFocus();
+                break;
+
+            case AuthService::RegisterResult::InvalidInput:
+                showError("Некорректные данные. Проверьте заполнение всех полей.");
+                break;
+
+            case AuthService::RegisterResult::DatabaseError:
+                showError("Ошибка базы данных. Попробуйте позже.");
+                break;
+        }
+    });
 }
 
 void LoginWidget::onAdminLoginClicked() {
@@ -241,3 +252,8 @@ void LoginWidget::showError(const QString& message) {
 void LoginWidget::showSuccess(const QString& message) {
     QMessageBox::information(this, "Успех", message);
 }
+
+void LoginWidget::setBusy(bool busy) {
+    m_loginButton->setEnabled(!busy);
+    m_registerButton->setEnabled(!busy);
+}
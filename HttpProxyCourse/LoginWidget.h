@@ -97,6 +97,12 @@ private:
      */
     void showSuccess(const QString& message);
 
+    /**
+     * @brief Блокирует кнопки входа и регистрации, пока запрос к БД выполняется.
+     * @param busy true на время запроса.
+     */
+    void setBusy(bool busy);
+
     // Вкладки
     QTabWidget* m_tabWidget;
 
@@ -1,7 +1,9 @@
 #include "ProgressDao.h"
 #include "DatabaseManager.h"
+#include "DbExecutor.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QStringList>
 #include <QDebug>
 
 UserProgress ProgressDao::findByUserId(int userId) {
@@ -13,8 +15,7 @@ UserProgress ProgressDao::findByUserId(int userId) {
         return progress;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT user_id, last_topic_id, updated_at FROM progress WHERE user_id = ?");
+    QSqlQuery query = dbManager.preparedQuery("SELECT user_id, last_topic_id, updated_at FROM progress WHERE user_id = ?");
     query.addBindValue(userId);
     
     if (!query.exec()) {
@@ -38,22 +39,15 @@ bool ProgressDao::updateProgress(int userId, int topicId) {
         return false;
     }
     
-    // Сначала проверяем, существует ли запись
-    UserProgress existing = findByUserId(userId);
-    
-    QSqlQuery query(dbManager.database());
-    
-    if (existing.userId > 0) {
-        // Обновляем существующую запись
-        query.prepare("UPDATE progress SET last_topic_id = ?, updated_at = CURRENT_TIMESTAMP WHERE user_id = ?");
-        query.addBindValue(topicId);
-        query.addBindValue(userId);
-    } else {
-        // Создаем новую запись
-        query.prepare("INSERT INTO progress (user_id, last_topic_id, updated_at) VALUES (?, ?, CURRENT_TIMESTAMP)");
-        query.addBindValue(userId);
-        query.addBindValue(topicId);
-    }
+    // Один запрос вместо SELECT и последующего UPDATE/INSERT
+    QSqlQuery query = dbManager.preparedQuery(R"(
+        INSERT INTO progress (user_id, last_topic_id, updated_at) 
+        VALUES (?, ?, CURRENT_TIMESTAMP)
+        ON CONFLICT (user_id) 
+        DO UPDATE SET last_topic_id = EXCLUDED.last_topic_id, updated_at = EXCLUDED.updated_at
+    )");
+    query.addBindValue(userId);
+    query.addBindValue(topicId);
     
     if (!query.exec()) {
         qCritical() << "Failed to update progress:" << query.lastError().text();
@@ -64,6 +58,50 @@ bool ProgressDao::updateProgress(int userId, int topicId) {
     return true;
 }
 
+bool ProgressDao::saveBatch(const QList<UserProgress>& progress) {
+    if (progress.isEmpty()) {
+        return true;
+    }
+
+    DatabaseManager& dbManager = DatabaseManager::instance();
+    if (!dbManager.isConnected()) {
+        qWarning() << "Database not connected in ProgressDao::saveBatch";
+        return false;
+    }
+
+    for (int first = 0; first < progress.size(); first += MaxBatchRows) {
+        const int count = qMin(MaxBatchRows, progress.size() - first);
+
+        // Текст зависит от числа строк, поэтому запрос не берется из кэша подготовленных
+        QStringList rows;
+        rows.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            rows << "(?, ?, ?)";
+        }
+        QSqlQuery query(dbManager.database());
+        query.prepare(QString(R"(
+            INSERT INTO progress (user_id, last_topic_id, updated_at) 
+            VALUES %1
+            ON CONFLICT (user_id) 
+            DO UPDATE SET last_topic_id = EXCLUDED.last_topic_id, updated_at = EXCLUDED.updated_at
+        )").arg(rows.join(", ")));
+
+        for (int i = first; i < first + count; ++i) {
+            query.addBindValue(progress[i].userId);
+            query.addBindValue(progress[i].lastTopicId);
+            query.addBindValue(progress[i].updatedAt);
+        }
+
+        if (!query.exec()) {
+            qCritical() << "Failed to save progress batch:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    qDebug() << "Progress batch saved:" << progress.size() << "users";
+    return true;
+}
+
 bool ProgressDao::createProgress(int userId, int topicId) {
     DatabaseManager& dbManager = DatabaseManager::instance();
     if (!dbManager.isConnected()) {
@@ -71,8 +109,7 @@ bool ProgressDao::createProgress(int userId, int topicId) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("INSERT INTO progress (user_id, last_topic_id, updated_at) VALUES (?, ?, CURRENT_TIMESTAMP)");
+    QSqlQuery query = dbManager.preparedQuery("INSERT INTO progress (user_id, last_topic_id, updated_at) VALUES (?, ?, CURRENT_TIMESTAMP)");
     query.addBindValue(userId);
     query.addBindValue(topicId);
     
@@ -91,8 +128,7 @@ bool ProgressDao::deleteByUserId(int userId) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("DELETE FROM progress WHERE user_id = ?");
+    QSqlQuery query = dbManager.preparedQuery("DELETE FROM progress WHERE user_id = ?");
     query.addBindValue(userId);
     
     if (!query.exec()) {
@@ -101,4 +137,20 @@ bool ProgressDao::deleteByUserId(int userId) {
     }
     
     return query.numRowsAffected() > 0;
-}
\ No newline at end of file
+}
+
+QFuture<UserProgress> ProgressDao::findByUserIdAsync(int userId) {
+    return DbExecutor::run([userId]() { return findByUserId(userId); });
+}
+
+QFuture<bool> ProgressDao::updateProgressAsync(int userId, int topicId) {
+    return DbExecutor::run([userId, topicId]() { return updateProgress(userId, topicId); });
+}
+
+QFuture<bool> ProgressDao::createProgressAsync(int userId, int topicId) {
+    return DbExecutor::run([userId, topicId]() { return createProgress(userId, topicId); });
+}
+
+QFuture<bool> ProgressDao::deleteByUserIdAsync(int userId) {
+    return DbExecutor::run([userId]() { return deleteByUserId(userId); });
+}
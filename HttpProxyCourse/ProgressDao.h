@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QString>
+#include <QList>
+#include <QFuture>
 #include <QDateTime>
 
 /**
@@ -46,6 +48,20 @@ public:
      */
     static bool updateProgress(int userId, int topicId);
 
+    /// @brief Наибольшее число строк в одном запросе saveBatch().
+    static constexpr int MaxBatchRows = 200;
+
+    /**
+     * @brief Записать прогресс нескольких пользователей одним запросом INSERT ... ON CONFLICT.
+     *
+     * Список не должен содержать двух записей одного пользователя.
+     * Больше MaxBatchRows записей разбиваются на несколько запросов.
+     *
+     * @param progress Записи прогресса (время обновления берется из updatedAt).
+     * @return true, если все записи сохранены.
+     */
+    static bool saveBatch(const QList<UserProgress>& progress);
+
     /**
      * @brief Создать запись о прогрессе для нового пользователя.
      * @param userId ID пользователя.
@@ -60,4 +76,18 @@ public:
      * @return true, если удаление прошло успешно.
      */
     static bool deleteByUserId(int userId);
+
+    // Асинхронные варианты для потока интерфейса: сохранение прогресса
+    // при переходе между темами не ждет ответа сервера.
+    /// @brief Асинхронный findByUserId().
+    static QFuture<UserProgress> findByUserIdAsync(int userId);
+
+    /// @brief Асинхронный updateProgress().
+    static QFuture<bool> updateProgressAsync(int userId, int topicId);
+
+    /// @brief Асинхронный createProgress().
+    static QFuture<bool> createProgressAsync(int userId, int topicId = 0);
+
+    /// @brief Асинхронный deleteByUserId().
+    static QFuture<bool> deleteByUserIdAsync(int userId);
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "ProgressWriter.h"
+#include "DatabaseConfig.h"
+#include "DatabaseManager.h"
+#include "DbExecutor.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+ProgressWriter::ProgressWriter() {
+    connect(&m_flushTimer, &QTimer::timeout, this, [this]() { flush(); });
+}
+
+ProgressWriter& ProgressWriter::instance() {
+    static ProgressWriter instance;
+    return instance;
+}
+
+void ProgressWriter::record(int userId, int topicId) {
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry& entry = m_entries[userId];
+        entry.topicId = topicId;
+        entry.updatedAt = QDateTime::currentDateTime();
+        entry.dirty = true;
+    }
+
+    // Таймер запускается при первом изменении, когда конфигурация БД уже загружена
+    QMetaObject::invokeMethod(this, [this]() {
+        if (!m_flushTimer.isActive()) {
+            m_flushTimer.start(DatabaseConfig::instance().progressFlushInterval() * 1000);
+        }
+    });
+}
+
+int ProgressWriter::lastTopic(int userId) const {
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_entries.constFind(userId);
+    return it != m_entries.constEnd() ? it->topicId : -1;
+}
+
+QFuture<bool> ProgressWriter::flush() {
+    if (!DatabaseManager::instance().isConnected()) {
+        return QFuture<bool>();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_inFlight.isRunning()) {
+        return m_inFlight;
+    }
+
+    QList<UserProgress> batch;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->dirty) {
+            batch.append(UserProgress(it.key(), it->topicId, it->updatedAt));
+            it->dirty = false;
+        }
+    }
+    if (batch.isEmpty()) {
+        return QFuture<bool>();
+    }
+
+    m_inFlight = DbExecutor::run([this, batch]() {
+        const bool saved = ProgressDao::saveBatch(batch);
+        finishFlush(batch, saved);
+        return saved;
+    });
+    return m_inFlight;
+}
+
+void ProgressWriter::shutdown() {
+    m_flushTimer.stop();
+
+    QFuture<bool> inFlight;
+    {
+        QMutexLocker locker(&m_mutex);
+        inFlight = m_inFlight;
+    }
+    inFlight.waitForFinished();
+    flush().waitForFinished();
+
+    QMutexLocker locker(&m_mutex);
+    int unsaved = 0;
+    for (const Entry& entry : qAsConst(m_entries)) {
+        unsaved += entry.dirty ? 1 : 0;
+    }
+    if (unsaved > 0) {
+        qWarning() << "Progress of" << unsaved << "users was not saved to the database";
+    }
+}
+
+void ProgressWriter::finishFlush(const QList<UserProgress>& batch, bool saved) {
+    QMutexLocker locker(&m_mutex);
+    for (const UserProgress& progress : batch) {
+        // Более новое значение уже помечено измененным и будет записано вместо этого
+        const auto it = m_entries.find(progress.userId);
+        if (it == m_entries.end() || it->dirty || it->updatedAt != progress.updatedAt
+            || it->topicId != progress.lastTopicId) {
+            continue;
+        }
+        if (saved) {
+            // Записанное значение читается из БД: там оно может смениться с другого компьютера
+            m_entries.erase(it);
+        } else {
+            it->dirty = true;
+        }
+    }
+}
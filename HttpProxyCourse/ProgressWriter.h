@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ProgressDao.h"
+#include <QObject>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+
+/**
+ * @brief Отложенная запись прогресса студентов.
+ *
+ * Хранит в памяти последнюю тему пользователя, пока она не записана в БД,
+ * и записывает измененные записи пачкой (ProgressDao::saveBatch) раз в
+ * DatabaseConfig::progressFlushInterval() секунд и при завершении работы.
+ * Частые переходы между темами одного пользователя сливаются в одну запись.
+ *
+ * Запись выполняется в пуле потоков БД; одновременно идет не больше одной
+ * записи, поэтому более старое значение не может перезаписать новое.
+ * Если запись не удалась, значения остаются измененными до следующей попытки;
+ * успешно записанные значения удаляются из памяти.
+ */
+class ProgressWriter : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Получить единственный экземпляр ProgressWriter.
+     * @return Ссылка на экземпляр.
+     */
+    static ProgressWriter& instance();
+
+    /**
+     * @brief Запомнить последнюю тему пользователя.
+     * @param userId ID пользователя.
+     * @param topicId ID последней изученной темы.
+     */
+    void record(int userId, int topicId);
+
+    /**
+     * @brief Получить еще не записанную в БД последнюю тему пользователя.
+     * Может вызываться из любого потока.
+     * @param userId ID пользователя.
+     * @return ID темы, ожидающей записи или записываемой сейчас; -1, если такой
+     *         нет (тогда прогресс читается из БД).
+     */
+    int lastTopic(int userId) const;
+
+    /**
+     * @brief Записать накопленные изменения в БД.
+     * @return Future результата записи; если предыдущая запись еще идет —
+     *         ее future, а новые изменения дождутся следующего вызова.
+     */
+    QFuture<bool> flush();
+
+    /**
+     * @brief Остановить периодическую запись и синхронно записать все изменения.
+     * Вызывается при завершении приложения, пока пул соединений еще работает.
+     */
+    void shutdown();
+
+private:
+    /**
+     * @brief Приватный конструктор для реализации паттерна Singleton.
+     */
+    ProgressWriter();
+
+    /**
+     * @brief Запретить копирование.
+     */
+    ProgressWriter(const ProgressWriter&) = delete;
+    ProgressWriter& operator=(const ProgressWriter&) = delete;
+
+    /**
+     * @brief Прогресс пользователя в памяти.
+     */
+    struct Entry {
+        int topicId = -1;     ///< Последняя тема
+        QDateTime updatedAt;  ///< Время выбора темы
+        bool dirty = false;   ///< Еще не записано в БД
+    };
+
+    /**
+     * @brief Завершить запись пачки: удалить записанные значения или вернуть их в число измененных.
+     * @param batch Записи пачки.
+     * @param saved Пачка записана успешно.
+     */
+    void finishFlush(const QList<UserProgress>& batch, bool saved);
+
+    mutable QMutex m_mutex;         ///< Защищает m_entries и m_inFlight
+    QHash<int, Entry> m_entries;    ///< Незаписанный прогресс по ID пользователя
+    QFuture<bool> m_inFlight;       ///< Текущая запись в БД
+    QTimer m_flushTimer;            ///< Период записи
+};
@@ -0,0 +1,442 @@
+#include "SearchIndex.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+namespace {
+
+/// @brief Вес слов названия темы относительно слов теории.
+constexpr float TitleWeight = 5.0f;
+
+/// @brief Вес слов заголовка раздела.
+constexpr float HeadingWeight = 3.0f;
+
+/// @brief Наименьшая длина основы после отбрасывания окончания.
+constexpr int MinStemLength = 3;
+
+/**
+ * @brief Окончания русских слов (падежные, глагольные, причастные), самые длинные — первыми.
+ */
+const QStringList& russianEndings() {
+    static const QStringList endings = []() {
+        QStringList list = {
+            // Деепричастия и глаголы
+            "ившись", "ывшись", "вшись", "ивши", "ывши", "ейте", "уйте", "ила", "ыла", "ена", "ите",
+            "или", "ыли", "ило", "ыло", "ено", "ует", "уют", "ены", "ить", "ыть", "ишь", "ешь", "ете",
+            "йте", "ят", "ит", "ыт", "ил", "ыл", "ен", "ла", "на", "ли", "ло", "но", "ет", "ют", "ны", "ть",
+            // Прилагательные и причастия
+            "ими", "ыми", "его", "ого", "ему", "ому", "ее", "ие", "ые", "ое", "ей", "ий", "ый", "ой",
+            "ем", "им", "ым", "ом", "их", "ых", "ую", "юю", "ая", "яя", "ою", "ею",
+            // Существительные
+            "иями", "ями", "ами", "ией", "иям", "ием", "иях", "ев", "ов", "ье", "ям", "ам", "ах", "ях",
+            "ию", "ью", "ия", "ья", "а", "е", "и", "й", "о", "у", "ы", "ь", "ю", "я"
+        };
+        list.removeDuplicates();
+        std::stable_sort(list.begin(), list.end(), [](const QString& a, const QString& b) {
+            return a.size() > b.size();
+        });
+        return list;
+    }();
+    return endings;
+}
+
+QString stemRussian(QString word) {
+    // Возвратная частица отбрасывается до окончания: «настраивается» -> «настраивает»
+    if ((word.endsWith(QStringLiteral("ся")) || word.endsWith(QStringLiteral("сь")))
+        && word.size() - 2 >= MinStemLength) {
+        word.chop(2);
+    }
+    for (const QString& ending : russianEndings()) {
+        if (word.size() - ending.size() >= MinStemLength && word.endsWith(ending)) {
+            word.chop(ending.size());
+            break;
+        }
+    }
+    if (word.size() > MinStemLength && word.endsWith(QChar(0x044C))) {  // ь
+        word.chop(1);
+    }
+    return word;
+}
+
+bool hasVowel(const QString& word) {
+    return std::any_of(word.cbegin(), word.cend(), [](QChar ch) {
+        return QStringLiteral("aeiouy").contains(ch);
+    });
+}
+
+QString stemEnglish(QString word) {
+    // Множественное число
+    if (word.endsWith(QLatin1String("sses"))) {
+        word.chop(2);
+    } else if (word.endsWith(QLatin1String("ies")) && word.size() > MinStemLength + 1) {
+        word.chop(2);
+    } else if (word.endsWith(QLatin1Char('s')) && !word.endsWith(QLatin1String("ss"))
+               && !word.endsWith(QLatin1String("us")) && word.size() > MinStemLength) {
+        word.chop(1);
+    }
+
+    // Словообразовательные и глагольные суффиксы
+    static const char* const suffixes[] = { "ational", "ization", "ation", "ments", "ment", "ness",
+                                            "edly", "ing", "ed", "ly" };
+    for (const char* suffix : suffixes) {
+        const QLatin1String ending(suffix);
+        if (word.endsWith(ending) && word.size() - ending.size() >= MinStemLength
+            && hasVowel(word.left(word.size() - ending.size()))) {
+            word.chop(ending.size());
+            break;
+        }
+    }
+
+    if (word.endsWith(QLatin1Char('e')) && word.size() > MinStemLength) {
+        word.chop(1);
+    }
+    if (word.endsWith(QLatin1Char('y')) && word.size() > MinStemLength) {
+        word[word.size() - 1] = QLatin1Char('i');
+    }
+    return word;
+}
+
+/**
+ * @brief Делит текст на слова после case folding («ё» приводится к «е»).
+ * Однобуквенные слова не индексируются.
+ */
+QStringList foldedWords(const QString& text) {
+    QStringList words;
+    QString word;
+    const auto flush = [&]() {
+        if (word.size() > 1) {
+            words.append(word);
+        }
+        word.clear();
+    };
+
+    for (QChar ch : text) {
+        if (ch.isLetterOrNumber()) {
+            if (ch == QChar(0x0451) || ch == QChar(0x0401)) {  // ё, Ё
+                ch = QChar(0x0435);
+            }
+            word.append(ch.toCaseFolded());
+        } else {
+            flush();
+        }
+    }
+    flush();
+    return words;
+}
+
+/**
+ * @brief Декодирует сущность HTML, начинающуюся в позиции pos.
+ * @param end Сюда записывается позиция после сущности.
+ * @return Символ сущности или '&', если это не сущность.
+ */
+QChar decodeEntity(const QString& html, int pos, int* end) {
+    *end = pos + 1;
+    const int semicolon = html.indexOf(QLatin1Char(';'), pos);
+    if (semicolon < 0 || semicolon - pos > 10) {
+        return QLatin1Char('&');
+    }
+
+    const QString name = html.mid(pos + 1, semicolon - pos - 1);
+    QChar result;
+    if (name.startsWith(QLatin1Char('#'))) {
+        bool ok = false;
+        const uint code = name.startsWith(QLatin1String("#x"), Qt::CaseInsensitive)
+                              ? name.midRef(2).toUInt(&ok, 16) : name.midRef(1).toUInt(&ok);
+        result = ok && code > 0 && code <= 0xFFFF ? QChar(code) : QChar(QLatin1Char(' '));
+    } else if (name == QLatin1String("amp")) {
+        result = QLatin1Char('&');
+    } else if (name == QLatin1String("lt")) {
+        result = QLatin1Char('<');
+    } else if (name == QLatin1String("gt")) {
+        result = QLatin1Char('>');
+    } else if (name == QLatin1String("quot")) {
+        result = QLatin1Char('"');
+    } else if (name == QLatin1String("apos")) {
+        result = QLatin1Char('\'');
+    } else {
+        result = QLatin1Char(' ');  // &nbsp; и прочие сущности разделяют слова
+    }
+    *end = semicolon + 1;
+    return result;
+}
+
+bool isSectionHeading(const QString& tagName) {
+    return tagName == QLatin1String("h1") || tagName == QLatin1String("h2") || tagName == QLatin1String("h3");
+}
+
+} // namespace
+
+SearchIndexPtr SearchIndex::build(const SharedCoursePtr& course) {
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<int> indexes(course ? course->topicCount() : 0);
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    const std::function<TopicTerms(int)> analyze = [course](int index) {
+        try {
+            // Временное декодирование не оставляет тела тем в снимке
+            if (TopicPtr topic = course->readTopic(index)) {
+                return analyzeTopic(*topic);
+            }
+        } catch (const std::exception& e) {
+            qWarning() << "Search index skips body of topic" << index << ":" << e.what();
+        }
+        // Поврежденная тема находится хотя бы по названию
+        Topic titleOnly;
+        titleOnly.title = course->topicTitle(index);
+        return analyzeTopic(titleOnly);
+    };
+
+    // Разбор тем идет параллельно, слияние — по порядку тем
+    QSharedPointer<SearchIndex> index = QSharedPointer<SearchIndex>::create(
+        QtConcurrent::blockingMappedReduced<SearchIndex>(
+            indexes, analyze,
+            [](SearchIndex& result, const TopicTerms& topic) {
+                result.addTopic(topic);
+            },
+            QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce));
+
+    index->m_sortedTerms.resize(index->m_terms.size());
+    std::iota(index->m_sortedTerms.begin(), index->m_sortedTerms.end(), 0);
+    const QStringList& terms = index->m_terms;
+    std::sort(index->m_sortedTerms.begin(), index->m_sortedTerms.end(), [&terms](int a, int b) {
+        return terms[a] < terms[b];
+    });
+
+    qDebug() << "Search index built:" << index->topicCount() << "topics," << index->termCount()
+             << "terms in" << timer.elapsed() << "ms";
+    return index;
+}
+
+QVector<SearchHit> SearchIndex::search(const QString& query, int maxResults) const {
+    QStringList words = foldedWords(query);
+    if (words.isEmpty() || maxResults <= 0) {
+        return {};
+    }
+    if (words.size() > MaxQueryTerms) {
+        words = words.mid(0, MaxQueryTerms);
+    }
+
+    // Недописанное последнее слово ищется и как префикс
+    const bool prefixLast = !query.isEmpty() && query.back().isLetterOrNumber();
+    QVector<QVector<int>> groups;
+    for (int i = 0; i < words.size(); ++i) {
+        const QVector<int> ids = lookup(words[i], prefixLast && i == words.size() - 1);
+        if (ids.isEmpty()) {
+            return {};
+        }
+        groups.append(ids);
+    }
+
+    const int topics = topicCount();
+    const int sections = m_sectionTopic.size();
+    QVector<float> sectionScores(sections, 0.0f);
+    QVector<float> topicScores(topics, 0.0f);
+    QVector<quint32> topicMasks(topics, 0);
+    QVector<int> candidates;
+
+    for (int i = 0; i < groups.size(); ++i) {
+        const quint32 bit = 1u << i;
+        for (int id : groups[i]) {
+            const QVector<Posting>& postings = m_postings[id];
+            const float idf = std::log(1.0f + float(sections) / float(postings.size()));
+            for (const Posting& posting : postings) {
+                const int topic = m_sectionTopic[posting.section];
+                if (i > 0 && !topicMasks[topic]) {
+                    continue;  // Тема без первого слова запроса в результат не попадет
+                }
+                const float score = (1.0f + std::log(posting.weight)) * idf;
+                sectionScores[posting.section] += score;
+                topicScores[topic] += score;
+                if (i == 0 && !topicMasks[topic]) {
+                    candidates.append(topic);
+                }
+                topicMasks[topic] |= bit;
+            }
+        }
+    }
+
+    const quint32 allTerms = (1u << groups.size()) - 1;
+    QVector<SearchHit> hits;
+    for (int topic : candidates) {
+        if (topicMasks[topic] != allTerms) {
+            continue;
+        }
+        const int first = m_sectionBase[topic];
+        const int last = topic + 1 < topics ? m_sectionBase[topic + 1] : sections;
+        const int best = static_cast<int>(std::max_element(sectionScores.cbegin() + first, sectionScores.cbegin() + last)
+                                          - sectionScores.cbegin());
+
+        SearchHit hit;
+        hit.topicIndex = topic;
+        hit.section = best == last - 1 ? -1 : best - first;
+        hit.sectionTitle = m_sectionTitles[best];
+        hit.score = topicScores[topic];
+        hits.append(hit);
+    }
+
+    const auto byScore = [](const SearchHit& a, const SearchHit& b) {
+        return a.score > b.score || (a.score == b.score && a.topicIndex < b.topicIndex);
+    };
+    if (hits.size() > maxResults) {
+        std::partial_sort(hits.begin(), hits.begin() + maxResults, hits.end(), byScore);
+        hits.resize(maxResults);
+    } else {
+        std::sort(hits.begin(), hits.end(), byScore);
+    }
+    return hits;
+}
+
+QStringList SearchIndex::terms(const QString& text) {
+    QStringList words = foldedWords(text);
+    for (QString& word : words) {
+        word = stem(word);
+    }
+    return words;
+}
+
+QString SearchIndex::stem(const QString& word) {
+    bool cyrillic = true;
+    bool latin = true;
+    for (QChar ch : word) {
+        cyrillic = cyrillic && ch.unicode() >= 0x0430 && ch.unicode() <= 0x044F;
+        latin = latin && ch >= QLatin1Char('a') && ch <= QLatin1Char('z');
+    }
+
+    // Слова с цифрами и смешанным алфавитом (http2, x-forwarded-for) не изменяются
+    if (cyrillic) {
+        return stemRussian(word);
+    }
+    return latin ? stemEnglish(word) : word;
+}
+
+SearchIndex::TopicTerms SearchIndex::analyzeTopic(const Topic& topic) {
+    TopicTerms result;
+    result.sectionTitles.append(QString());
+    result.sectionWeights.resize(1);
+
+    const auto addText = [&result](const QString& text, float weight) {
+        QHash<QString, float>& weights = result.sectionWeights.last();
+        for (const QString& term : terms(text)) {
+            weights[term] += weight;
+        }
+    };
+    addText(topic.title, TitleWeight);
+
+    const QString& html = topic.htmlContent;
+    QString text;
+    QString heading;
+    bool inHeading = false;
+    int pos = 0;
+    while (pos < html.size()) {
+        const QChar ch = html[pos];
+        if (ch == QLatin1Char('&')) {
+            int end = pos;
+            (inHeading ? heading : text).append(decodeEntity(html, pos, &end));
+            pos = end;
+            continue;
+        }
+        if (ch != QLatin1Char('<')) {
+            (inHeading ? heading : text).append(ch);
+            ++pos;
+            continue;
+        }
+
+        const int close = html.indexOf(QLatin1Char('>'), pos);
+        if (close < 0) {
+            break;
+        }
+        int nameStart = pos + 1;
+        const bool closing = nameStart < close && html[nameStart] == QLatin1Char('/');
+        if (closing) {
+            ++nameStart;
+        }
+        int nameEnd = nameStart;
+        while (nameEnd < close && html[nameEnd].isLetterOrNumber()) {
+            ++nameEnd;
+        }
+        const QString name = html.mid(nameStart, nameEnd - nameStart).toLower();
+        pos = close + 1;
+
+        if (!closing && (name == QLatin1String("style") || name == QLatin1String("script"))) {
+            // Содержимое стилей и скриптов не является текстом темы
+            const int endTag = html.indexOf(QLatin1String("</") + name, pos, Qt::CaseInsensitive);
+            const int endClose = endTag < 0 ? -1 : html.indexOf(QLatin1Char('>'), endTag);
+            pos = endClose < 0 ? html.size() : endClose + 1;
+        } else if (isSectionHeading(name) && !closing) {
+            addText(text, 1.0f);
+            text.clear();
+            heading.clear();
+            inHeading = true;
+            result.sectionTitles.append(QString());
+            result.sectionWeights.append(QHash<QString, float>());
+        } else if (isSectionHeading(name) && inHeading) {
+            inHeading = false;
+            result.sectionTitles.last() = heading.simplified();
+            addText(heading, HeadingWeight);
+        } else {
+            // Теги разделяют слова: «<td>GET</td><td>POST</td>» — два слова
+            (inHeading ? heading : text).append(QLatin1Char(' '));
+        }
+    }
+    addText(inHeading ? heading : text, 1.0f);
+
+    // Вопросы теста — отдельный последний раздел
+    result.sectionTitles.append(QStringLiteral("Вопросы теста"));
+    result.sectionWeights.append(QHash<QString, float>());
+    for (const Question& question : topic.questions) {
+        addText(question.text, 1.0f);
+    }
+    return result;
+}
+
+void SearchIndex::addTopic(const TopicTerms& topic) {
+    const int topicIndex = m_sectionBase.size();
+    const int base = m_sectionTopic.size();
+    m_sectionBase.append(base);
+    m_sectionTitles += topic.sectionTitles;
+
+    for (int section = 0; section < topic.sectionWeights.size(); ++section) {
+        m_sectionTopic.append(topicIndex);
+        const QHash<QString, float>& weights = topic.sectionWeights[section];
+        for (auto it = weights.cbegin(); it != weights.cend(); ++it) {
+            auto id = m_termIds.find(it.key());
+            if (id == m_termIds.end()) {
+                id = m_termIds.insert(it.key(), m_terms.size());
+                m_terms.append(it.key());
+                m_postings.append(QVector<Posting>());
+            }
+            m_postings[id.value()].append(Posting{ quint32(base + section), it.value() });
+        }
+    }
+}
+
+QVector<int> SearchIndex::lookup(const QString& word, bool prefix) const {
+    QVector<int> ids;
+    const auto exact = m_termIds.constFind(stem(word));
+    const int exactId = exact != m_termIds.cend() ? exact.value() : -1;
+    if (exactId >= 0) {
+        ids.append(exactId);
+    }
+    if (!prefix) {
+        return ids;
+    }
+
+    // Основы — префиксы слов, поэтому «прок» находит основу «прокс» слова «прокси»
+    auto it = std::lower_bound(m_sortedTerms.cbegin(), m_sortedTerms.cend(), word,
+                               [this](int id, const QString& value) { return m_terms[id] < value; });
+    for (int expanded = 0; it != m_sortedTerms.cend() && expanded < MaxPrefixExpansions; ++it, ++expanded) {
+        if (!m_terms[*it].startsWith(word)) {
+            break;
+        }
+        if (*it != exactId) {
+            ids.append(*it);
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "SharedCourse.h"
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class SearchIndex;
+
+/// @brief Разделяемый неизменяемый поисковый индекс.
+using SearchIndexPtr = QSharedPointer<const SearchIndex>;
+
+/**
+ * @brief Результат полнотекстового поиска.
+ */
+struct SearchHit {
+    int topicIndex = -1;   ///< Индекс темы в курсе
+    int section = 0;       ///< Раздел темы: 0 — начало, k — k-й заголовок h1–h3, -1 — вопросы теста
+    QString sectionTitle;  ///< Заголовок раздела (пустой для начала темы)
+    double score = 0.0;    ///< Релевантность темы
+};
+
+/**
+ * @brief Инвертированный индекс по теории и вопросам курса.
+ *
+ * Текст темы делится на разделы по заголовкам h1–h3 (как в TopicDocument),
+ * слова приводятся к нижнему регистру (case folding, «ё» → «е») и к основе
+ * облегченным стеммером для русского и английского языков. Для каждой основы
+ * хранится список разделов с весом вхождений, поэтому запрос просматривает
+ * только списки своих слов и не зависит от объема курса.
+ *
+ * Ранжирование — TF-IDF: вес слова в разделе растет логарифмически с числом
+ * вхождений, слова названия темы весят больше. Тема попадает в результат,
+ * только если содержит все слова запроса; последнее слово запроса, пока его
+ * не завершили пробелом, ищется и как префикс (поиск по мере ввода).
+ *
+ * Индекс неизменяем после build() и может использоваться из любого потока.
+ */
+class SearchIndex {
+public:
+    /// @brief Наибольшее число слов запроса (остальные отбрасываются).
+    static constexpr int MaxQueryTerms = 8;
+
+    /// @brief Наибольшее число основ, которыми раскрывается префикс последнего слова.
+    static constexpr int MaxPrefixExpansions = 64;
+
+    /**
+     * @brief Строит индекс по всем темам курса.
+     *
+     * Темы разбираются параллельно; незагруженные темы декодируются из файла
+     * курса во временные объекты (SharedCourse::readTopic()) и в снимке не остаются.
+     * Поврежденные темы пропускаются с предупреждением в журнале.
+     *
+     * @param course Снимок курса.
+     * @return Готовый индекс.
+     */
+    static SearchIndexPtr build(const SharedCoursePtr& course);
+
+    /**
+     * @brief Ищет темы по запросу.
+     * @param query Текст запроса.
+     * @param maxResults Наибольшее число результатов.
+     * @return Темы в порядке убывания релевантности (по одной на тему, с лучшим разделом).
+     */
+    QVector<SearchHit> search(const QString& query, int maxResults = 50) const;
+
+    /**
+     * @brief Возвращает количество проиндексированных тем.
+     */
+    int topicCount() const { return m_sectionBase.size(); }
+
+    /**
+     * @brief Возвращает количество различных основ в индексе.
+     */
+    int termCount() const { return m_terms.size(); }
+
+    /**
+     * @brief Делит текст на слова и приводит их к основам.
+     * @param text Простой текст.
+     * @return Основы слов в порядке следования.
+     */
+    static QStringList terms(const QString& text);
+
+    /**
+     * @brief Приводит слово в нижнем регистре к основе.
+     * @param word Слово (результат case folding).
+     * @return Основа слова; слова без известных окончаний возвращаются как есть.
+     */
+    static QString stem(const QString& word);
+
+private:
+    /**
+     * @brief Вхождение основы в раздел.
+     */
+    struct Posting {
+        quint32 section;  ///< Глобальный номер раздела
+        float weight;     ///< Взвешенное число вхождений
+    };
+
+    /**
+     * @brief Разобранная тема до слияния в общий индекс.
+     */
+    struct TopicTerms {
+        QStringList sectionTitles;                     ///< Заголовки разделов (0 — пустой)
+        QVector<QHash<QString, float>> sectionWeights; ///< Веса основ по разделам; последний — вопросы
+    };
+
+    /**
+     * @brief Разбирает тему на разделы и основы.
+     */
+    static TopicTerms analyzeTopic(const Topic& topic);
+
+    /**
+     * @brief Добавляет разобранную тему в индекс.
+     */
+    void addTopic(const TopicTerms& topic);
+
+    /**
+     * @brief Находит идентификаторы основ для слова запроса.
+     * @param word Слово запроса после case folding.
+     * @param prefix Искать также основы, начинающиеся с word.
+     */
+    QVector<int> lookup(const QString& word, bool prefix) const;
+
+    QHash<QString, int> m_termIds;         ///< Основа -> идентификатор
+    QStringList m_terms;                   ///< Основы по идентификатору
+    QVector<int> m_sortedTerms;            ///< Идентификаторы основ в лексикографическом порядке
+    QVector<QVector<Posting>> m_postings;  ///< Списки вхождений по идентификатору основы
+    QVector<int> m_sectionBase;            ///< Первый глобальный раздел темы
+    QVector<int> m_sectionTopic;           ///< Тема глобального раздела
+    QStringList m_sectionTitles;           ///< Заголовки глобальных разделов
+};
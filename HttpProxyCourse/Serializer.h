@@ -6,14 +6,19 @@
 /**
  * @brief Класс для сохранения и загрузки данных курса.
  * Реализует строго бинарную сериализацию через QDataStream согласно ТЗ.
+ *
+ * Курс сохраняется в индексированный контейнер v3 с контрольными суммами
+ * (см. CourseStorage), файлы контейнера v2 и прежнего формата v1
+ * (сплошной поток QDataStream) по-прежнему читаются.
  */
 class Serializer {
 public:
     /**
      * @brief Сохраняет объект курса в бинарный файл.
      *
-     * Метод сериализует курс в чистый бинарный формат через QDataStream
-     * без какого-либо шифрования, согласно требованиям ТЗ.
+     * Метод сериализует курс в контейнер v3 без какого-либо шифрования,
+     * согласно требованиям ТЗ. Еще не загруженные темы читаются из исходного
+     * контейнера, а новый файл подменяет старый атомарно.
      *
      * @param course Объект курса для сохранения.
      * @param filePath Полный путь к файлу.
@@ -21,11 +26,30 @@ public:
      */
     static void save(const Course& course, const QString& filePath);
 
+    /**
+     * @brief Сохраняет одну измененную тему, не переписывая весь файл.
+     *
+     * Для контейнера v3 дописывает блок темы в конец файла и обновляет одну
+     * запись таблицы смещений (см. CourseJournal). Мертвые блоки убираются
+     * уплотнением при следующей загрузке курса.
+     * Если файл имеет другой формат или структуру, выполняется полное сохранение.
+     *
+     * @param course Объект курса.
+     * @param topicIndex Индекс измененной темы.
+     * @param filePath Полный путь к файлу.
+     * @throws std::runtime_error Если индекс неверный или запись не удалась.
+     */
+    static void saveTopic(const Course& course, int topicIndex, const QString& filePath);
+
     /**
      * @brief Загружает объект курса из бинарного файла.
      *
-     * Метод считывает данные через QDataStream и десериализует
-     * в структуру Course. Файл не читаем текстовыми редакторами.
+     * Для контейнера файл отображается в память и декодируются только
+     * названия тем; теория и вопросы подгружаются через ensureTopicLoaded()
+     * (или SharedCourse::topic() для общего снимка курса). Контрольные суммы
+     * заголовка и индекса проверяются сразу, блока темы — при ее подгрузке,
+     * так что поврежденная тема не мешает работе с остальными.
+     * Файл v1 десериализуется целиком. Файл не читаем текстовыми редакторами.
      *
      * @param filePath Полный путь к файлу.
      * @return Загруженный объект Course.
@@ -34,10 +58,29 @@ public:
     static Course load(const QString& filePath);
 
     /**
-     * @brief Создает начальные данные курса и сохраняет в бинарный файл.
+     * @brief Загружает курс из файла, а при неудаче — встроенный курс.
+     *
+     * Если файл отсутствует или не читается, возвращается DefaultCourse::create()
+     * без обращения к диску; файл курса создается при первом сохранении.
+     *
+     * @param filePath Полный путь к файлу.
+     * @return Загруженный или встроенный курс.
+     */
+    static Course loadOrDefault(const QString& filePath);
+
+    /**
+     * @brief Подгружает теорию и вопросы темы, если они еще не в памяти.
+     * @param course Курс, загруженный через load().
+     * @param topicIndex Индекс темы (0-based).
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    static void ensureTopicLoaded(Course& course, int topicIndex);
+
+    /**
+     * @brief Сохраняет встроенный курс (DefaultCourse) в бинарный файл.
      *
-     * Генерирует структуру курса с темами и вопросами согласно ТЗ
-     * и сохраняет в бинарном формате.
+     * Для запуска приложения не требуется: при отсутствии файла курс
+     * берется из исполняемого файла напрямую (см. loadOrDefault()).
      *
      * @param filePath Путь для сохранения файла курса.
      * @throws std::runtime_error Если не удалось создать или сохранить данные.
@@ -1,5 +1,7 @@
 #include "SessionManager.h"
 #include "DatabaseManager.h"
+#include "DbExecutor.h"
+#include "ProgressWriter.h"
 #include <stdexcept>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -15,8 +17,12 @@ SessionManager::SessionManager()
 
 void SessionManager::loadCourse(const QString& filePath) {
     try {
-        currentCourse = Serializer::load(filePath);
+        currentCourse = SharedCourse::loadOrDefault(filePath);
+        currentTopic.reset();
         m_isLoaded = true;
+
+        // Первый экран требует только названий; тела тем проверяются в фоне
+        SharedCourse::preloadInBackground(currentCourse);
         currentTopicIndex = -1;
         currentQuestionIndex = -1;
         errorsInTopic = 0;
@@ -26,6 +32,23 @@ void SessionManager::loadCourse(const QString& filePath) {
     }
 }
 
+void SessionManager::setCourse(const SharedCoursePtr& course) {
+    if (!course) {
+        return;
+    }
+
+    currentCourse = course;
+    m_isLoaded = true;
+
+    // Индексы сохраняются, если тема все еще существует
+    if (currentTopicIndex >= currentCourse->topicCount()) {
+        currentTopicIndex = -1;
+        currentQuestionIndex = -1;
+        errorsInTopic = 0;
+    }
+    currentTopic.reset();
+}
+
 bool SessionManager::isCourseLoaded() const {
     return m_isLoaded;
 }
@@ -35,32 +58,34 @@ void SessionManager::startTopic(int topicIndex) {
         throw std::runtime_error("Course not loaded");
     }
     // Безопасное сравнение индексов
-    if (topicIndex < 0 || topicIndex >= currentCourse.topics.size()) {
+    if (topicIndex < 0 || topicIndex >= currentCourse->topicCount()) {
         throw std::runtime_error("Invalid topic index");
     }
 
+    // Теория и вопросы темы декодируются только при ее открытии
+    currentTopic = currentCourse->topic(topicIndex);
+
     currentTopicIndex = topicIndex;
     currentQuestionIndex = 0;
     errorsInTopic = 0;
 }
 
-const Course& SessionManager::getCourse() const {
+SharedCoursePtr SessionManager::getCourse() const {
     return currentCourse;
 }
 
-Course& SessionManager::getMutableCourse() {
-    return currentCourse;
-}
-
-Topic* SessionManager::getCurrentTopic() {
-    if (!m_isLoaded || currentTopicIndex < 0 || currentTopicIndex >= currentCourse.topics.size()) {
+TopicPtr SessionManager::getCurrentTopic() {
+    if (!m_isLoaded || currentTopicIndex < 0 || currentTopicIndex >= currentCourse->topicCount()) {
         return nullptr;
     }
-    return &currentCourse.topics[currentTopicIndex];
+    if (!currentTopic) {
+        currentTopic = currentCourse->topic(currentTopicIndex);
+    }
+    return currentTopic;
 }
 
-Question* SessionManager::getCurrentQuestion() {
-    Topic* topic = getCurrentTopic();
+const Question* SessionManager::getCurrentQuestion() {
+    TopicPtr topic = getCurrentTopic();
     if (!topic) return nullptr;
 
     if (currentQuestionIndex < 0 || currentQuestionIndex >= topic->questions.size()) {
@@ -75,8 +100,8 @@ SessionManager::SubmitResult SessionManager::submitAnswer(int answerIndex) {
         throw std::runtime_error("Cannot submit answer: course not loaded");
     }
 
-    Topic* topic = getCurrentTopic();
-    Question* question = getCurrentQuestion();
+    TopicPtr topic = getCurrentTopic();
+    const Question* question = getCurrentQuestion();
 
     if (!topic || !question) {
         throw std::runtime_error("Cannot submit answer: invalid topic or question state");
@@ -96,7 +121,7 @@ SessionManager::SubmitResult SessionManager::submitAnswer(int answerIndex) {
         currentQuestionIndex++;
 
         if (currentQuestionIndex >= topic->questions.size()) {
-            if (currentTopicIndex >= currentCourse.topics.size() - 1) {
+            if (currentTopicIndex >= currentCourse->topicCount() - 1) {
                 return SubmitResult::CourseFinished;
             }
             return SubmitResult::TopicFinished;
@@ -114,10 +139,14 @@ SessionManager::SubmitResult SessionManager::submitAnswer(int answerIndex) {
 }
 
 void SessionManager::setCurrentUser(const User& user) {
-    m_currentUser = user;
-    if (user.isValid()) {
-        loadProgress();
+    // Тема предыдущего пользователя не должна выглядеть начатой новым
+    if (user.id != m_currentUser.id || user.login != m_currentUser.login) {
+        currentTopic.reset();
+        currentTopicIndex = -1;
+        currentQuestionIndex = -1;
+        errorsInTopic = 0;
     }
+    m_currentUser = user;
 }
 
 const User& SessionManager::getCurrentUser() const {
@@ -130,6 +159,7 @@ bool SessionManager::hasUser() const {
 
 void SessionManager::clearSession() {
     m_currentUser = User(); // Сброс пользователя
+    currentTopic.reset();
     currentTopicIndex = -1;
     currentQuestionIndex = -1;
     errorsInTopic = 0;
@@ -140,54 +170,59 @@ bool SessionManager::saveProgress() {
         return false;
     }
 
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(R"(
-        INSERT INTO progress (user_id, last_topic_id, updated_at) 
-        VALUES (?, ?, CURRENT_TIMESTAMP)
-        ON CONFLICT (user_id) 
-        DO UPDATE SET last_topic_id = ?, updated_at = CURRENT_TIMESTAMP
-    )");
-    
-    query.addBindValue(m_currentUser.id);
-    query.addBindValue(currentTopicIndex);
-    query.addBindValue(currentTopicIndex);
-
-    if (!query.exec()) {
-        qCritical() << "Failed to save progress:" << query.lastError().text();
-        return false;
-    }
-
-    qDebug() << "Progress saved for user" << m_currentUser.login << "topic" << currentTopicIndex;
+    // Прогресс копится в памяти и записывается в БД пачкой
+    ProgressWriter::instance().record(m_currentUser.id, currentTopicIndex);
     return true;
 }
 
-bool SessionManager::loadProgress() {
-    if (!hasUser() || !DatabaseManager::instance().isConnected()) {
-        return false;
-    }
+QFuture<int> SessionManager::loadProgressAsync() const {
+    const bool hasStoredProgress = hasUser();
+    const int userId = m_currentUser.id;
+    const QString login = m_currentUser.login;
+    return DbExecutor::run([hasStoredProgress, userId, login]() {
+        if (!hasStoredProgress) {
+            return -1;
+        }
 
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT last_topic_id FROM progress WHERE user_id = ?");
-    query.addBindValue(m_currentUser.id);
+        // Еще не записанное в БД значение новее сохраненного
+        const int pendingTopicId = ProgressWriter::instance().lastTopic(userId);
+        if (pendingTopicId >= 0 || !DatabaseManager::instance().isConnected()) {
+            return pendingTopicId;
+        }
+
+        QSqlQuery query = DatabaseManager::instance().preparedQuery("SELECT last_topic_id FROM progress WHERE user_id = ?");
+        query.addBindValue(userId);
 
-    if (!query.exec()) {
-        qCritical() << "Failed to load progress:" << query.lastError().text();
+        if (!query.exec()) {
+            qCritical() << "Failed to load progress:" << query.lastError().text();
+            return -1;
+        }
+
+        if (query.next()) {
+            int lastTopicId = query.value("last_topic_id").toInt();
+            qDebug() << "Loaded progress for user" << login << "last topic" << lastTopicId;
+            return lastTopicId;
+        }
+
+        qDebug() << "No progress found for user" << login;
+        return -1;
+    });
+}
+
+bool SessionManager::applyProgress(int lastTopicId) {
+    // Устанавливаем прогресс только если курс загружен
+    if (!m_isLoaded || lastTopicId < 0 || lastTopicId >= currentCourse->topicCount()) {
         return false;
     }
 
-    if (query.next()) {
-        int lastTopicId = query.value("last_topic_id").toInt();
-        qDebug() << "Loaded progress for user" << m_currentUser.login << "last topic" << lastTopicId;
-        
-        // Устанавливаем прогресс только если курс загружен
-        if (m_isLoaded && lastTopicId >= 0 && lastTopicId < currentCourse.topics.size()) {
-            currentTopicIndex = lastTopicId;
-            currentQuestionIndex = 0;
-            errorsInTopic = 0;
-        }
-        return true;
+    // Пока шел запрос, студент уже открыл тему: ее состояние не сбрасывается
+    if (currentTopicIndex >= 0) {
+        return false;
     }
 
-    qDebug() << "No progress found for user" << m_currentUser.login;
-    return false;
+    currentTopicIndex = lastTopicId;
+    currentTopic.reset();
+    currentQuestionIndex = 0;
+    errorsInTopic = 0;
+    return true;
 }
@@ -2,9 +2,11 @@
 
 #include "DomainTypes.h"
 #include "Serializer.h"
+#include "SharedCourse.h"
 #include <QString>
 #include <QList>
 #include <QDateTime>
+#include <QFuture>
 
 /**
  * @brief Менеджер сессии обучения.
@@ -34,6 +36,8 @@ public:
 
     /**
      * @brief Устанавливает текущего пользователя сессии.
+     * При смене пользователя текущая тема сбрасывается; прогресс загружается
+     * отдельно через loadProgressAsync() и applyProgress().
      * @param user Пользователь для установки.
      */
     void setCurrentUser(const User& user);
@@ -61,6 +65,13 @@ public:
      */
     void loadCourse(const QString& filePath);
 
+    /**
+     * @brief Заменяет курс новым снимком (например, после правки в панели администратора).
+     * Индекс текущей темы сохраняется, если тема осталась в курсе.
+     * @param course Новый снимок курса.
+     */
+    void setCourse(const SharedCoursePtr& course);
+
     /**
      * @brief Проверяет, загружен ли курс.
      * @return true, если курс загружен.
@@ -74,28 +85,24 @@ public:
     void startTopic(int topicIndex);
 
     /**
-     * @brief Возвращает константную ссылку на курс.
-     * @return Ссылка на объект курса.
+     * @brief Возвращает общий снимок курса.
+     * @return Снимок курса или nullptr, если курс не загружен.
      */
-    const Course& getCourse() const;
+    SharedCoursePtr getCourse() const;
 
     /**
-     * @brief Возвращает изменяемую ссылку на курс.
-     * @return Изменяемая ссылка на объект курса.
+     * @brief Возвращает текущую тему.
+     * Теория и вопросы темы подгружаются из файла курса при первом обращении.
+     * @return Текущая тема или nullptr.
+     * @throws std::runtime_error Если блок темы в файле поврежден.
      */
-    Course& getMutableCourse();
-
-    /**
-     * @brief Возвращает указатель на текущую тему.
-     * @return Указатель на текущую тему или nullptr.
-     */
-    Topic* getCurrentTopic();
+    TopicPtr getCurrentTopic();
 
     /**
      * @brief Возвращает указатель на текущий вопрос.
-     * @return Указатель на текущий вопрос или nullptr.
+     * @return Указатель на текущий вопрос или nullptr; действителен, пока не сменена тема.
      */
-    Question* getCurrentQuestion();
+    const Question* getCurrentQuestion();
 
     /**
      * @brief Обрабатывает ответ студента на текущий вопрос.
@@ -105,19 +112,31 @@ public:
     SubmitResult submitAnswer(int answerIndex);
 
     /**
-     * @brief Сохраняет прогресс пользователя в базу данных.
-     * @return true, если прогресс сохранен успешно.
+     * @brief Передает прогресс пользователя в ProgressWriter для отложенной записи.
+     * @return true, если прогресс принят к записи.
      */
     bool saveProgress();
 
     /**
-     * @brief Загружает прогресс пользователя из базы данных.
-     * @return true, если прогресс загружен успешно.
+     * @brief Загружает прогресс пользователя из базы данных в пуле потоков БД.
+     * @return Future с индексом последней изученной темы или -1, если прогресса нет.
+     */
+    QFuture<int> loadProgressAsync() const;
+
+    /**
+     * @brief Делает загруженную тему текущей.
+     *
+     * Результат, пришедший после того, как студент сам открыл тему,
+     * отбрасывается, чтобы не сбросить состояние открытой темы.
+     *
+     * @param lastTopicId Результат loadProgressAsync().
+     * @return true, если тема существует в загруженном курсе и другая тема еще не начата.
      */
-    bool loadProgress();
+    bool applyProgress(int lastTopicId);
 
 private:
-    Course currentCourse;
+    SharedCoursePtr currentCourse;
+    TopicPtr currentTopic;  ///< Удерживает тему, пока по ней идет сессия
     bool m_isLoaded;
     User m_currentUser;
 
@@ -0,0 +1,220 @@
+#include "SharedCourse.h"
+#include "CourseStorage.h"
+#include "CourseSnapshot.h"
+#include "Serializer.h"
+#include <QMutexLocker>
+#include <QtConcurrent>
+#include <QDebug>
+#include <functional>
+#include <stdexcept>
+
+SharedCourse::SharedCourse(const Course& course)
+    : m_storage(course.storage)
+{
+    m_topics.reserve(course.topics.size());
+    for (const Topic& topic : course.topics) {
+        if (topic.isBodyLoaded()) {
+            m_topics.append(makeLoadedSlot(topic));
+            continue;
+        }
+
+        auto slot = QSharedPointer<TopicSlot>::create();
+        slot->title = topic.title;
+        slot->storageIndex = topic.storageIndex;
+        m_topics.append(slot);
+    }
+}
+
+SharedCoursePtr SharedCourse::load(const QString& filePath) {
+    return SharedCoursePtr::create(Serializer::load(filePath));
+}
+
+SharedCoursePtr SharedCourse::loadOrDefault(const QString& filePath) {
+    return SharedCoursePtr::create(Serializer::loadOrDefault(filePath));
+}
+
+const QString& SharedCourse::topicTitle(int index) const {
+    if (index < 0 || index >= m_topics.size()) {
+        throw std::runtime_error("Invalid topic index");
+    }
+    return m_topics[index]->title;
+}
+
+QStringList SharedCourse::topicTitles() const {
+    QStringList titles;
+    titles.reserve(m_topics.size());
+    for (const auto& slot : m_topics) {
+        titles << slot->title;
+    }
+    return titles;
+}
+
+QByteArray SharedCourse::asset(const QString& name) const {
+    return m_storage ? m_storage->asset(name) : QByteArray();
+}
+
+TopicPtr SharedCourse::topic(int index) const {
+    ValidationReport report;
+    TopicPtr result = loadSlot(index, &report);
+    if (!report.isClean()) {
+        qWarning() << "Topic" << result->title << "validation:" << report.summary();
+    }
+    return result;
+}
+
+TopicPtr SharedCourse::loadedTopic(int index) const {
+    if (index < 0 || index >= m_topics.size()) {
+        return nullptr;
+    }
+    TopicSlot& slot = *m_topics[index];
+    QMutexLocker locker(&slot.mutex);
+    return slot.loaded;
+}
+
+ValidationReport SharedCourse::preloadAll() const {
+    if (!m_storage) {
+        return ValidationReport();
+    }
+
+    // Уже загруженные темы были проверены при загрузке
+    QVector<int> storageIndexes;
+    for (const auto& slot : m_topics) {
+        QMutexLocker locker(&slot->mutex);
+        if (!slot->loaded && slot->storageIndex >= 0) {
+            storageIndexes << slot->storageIndex;
+        }
+    }
+
+    QVector<QVector<int>> chunks;
+    for (int i = 0; i < storageIndexes.size(); i += TopicsPerPreloadTask) {
+        chunks << storageIndexes.mid(i, TopicsPerPreloadTask);
+    }
+
+    // Каждая задача декодирует свою пачку тем в одну арену и освобождает ее целиком.
+    // std::function дает result_type, необходимый QtConcurrent в Qt 5
+    const CourseStorage& storage = *m_storage;
+    const std::function<ValidationReport(const QVector<int>&)> decode = [&storage](const QVector<int>& chunk) {
+        ValidationReport report;
+        const CourseSnapshot snapshot(storage, chunk, &report);
+        return report;
+    };
+
+    return QtConcurrent::blockingMappedReduced<ValidationReport>(
+        chunks, decode,
+        [](ValidationReport& total, const ValidationReport& part) {
+            total.merge(part);
+        });
+}
+
+void SharedCourse::preloadInBackground(const SharedCoursePtr& course) {
+    if (!course) {
+        return;
+    }
+
+    QtConcurrent::run([course]() {
+        const ValidationReport report = course->preloadAll();
+        if (report.isClean()) {
+            qDebug() << "Course topics decoded and validated:" << report.summary();
+        } else {
+            qWarning() << "Course validation summary:" << report.summary();
+        }
+    });
+}
+
+TopicPtr SharedCourse::readTopic(int index, ValidationReport* report) const {
+    if (index < 0 || index >= m_topics.size()) {
+        throw std::runtime_error("Invalid topic index");
+    }
+
+    TopicSlot& slot = *m_topics[index];
+    {
+        QMutexLocker locker(&slot.mutex);
+        if (slot.loaded) {
+            return slot.loaded;
+        }
+    }
+    if (!m_storage) {
+        throw std::runtime_error("Topic body is not loaded and course storage is missing");
+    }
+
+    // Декодирование идет без блокировки ячейки: результат в нее не попадает
+    auto decoded = QSharedPointer<Topic>::create();
+    decoded->title = slot.title;
+    m_storage->readTopicBody(slot.storageIndex, *decoded, report);
+    return decoded;
+}
+
+TopicPtr SharedCourse::loadSlot(int index, ValidationReport* report) const {
+    if (index < 0 || index >= m_topics.size()) {
+        throw std::runtime_error("Invalid topic index");
+    }
+
+    TopicSlot& slot = *m_topics[index];
+    QMutexLocker locker(&slot.mutex);
+    if (!slot.loaded) {
+        if (!m_storage) {
+            throw std::runtime_error("Topic body is not loaded and course storage is missing");
+        }
+
+        // Тело темы загружается один раз для всех снимков, разделяющих ячейку
+        auto loaded = QSharedPointer<Topic>::create();
+        loaded->title = slot.title;
+        m_storage->readTopicBody(slot.storageIndex, *loaded, report);
+        slot.loaded = loaded;
+    }
+    return slot.loaded;
+}
+
+SharedCoursePtr SharedCourse::withTopic(int index, const Topic& topic) const {
+    if (index < 0 || index >= m_topics.size()) {
+        throw std::runtime_error("Invalid topic index");
+    }
+
+    QSharedPointer<SharedCourse> next(new SharedCourse(*this));
+    next->m_topics[index] = makeLoadedSlot(topic);
+    return next;
+}
+
+SharedCoursePtr SharedCourse::withAppendedTopic(const Topic& topic) const {
+    QSharedPointer<SharedCourse> next(new SharedCourse(*this));
+    next->m_topics.append(makeLoadedSlot(topic));
+    return next;
+}
+
+SharedCoursePtr SharedCourse::withoutTopic(int index) const {
+    if (index < 0 || index >= m_topics.size()) {
+        throw std::runtime_error("Invalid topic index");
+    }
+
+    QSharedPointer<SharedCourse> next(new SharedCourse(*this));
+    next->m_topics.removeAt(index);
+    return next;
+}
+
+Course SharedCourse::toCourse() const {
+    Course course;
+    course.storage = m_storage;
+    course.topics.reserve(m_topics.size());
+    for (const auto& slot : m_topics) {
+        QMutexLocker locker(&slot->mutex);
+        if (slot->loaded) {
+            course.topics.append(*slot->loaded);
+        } else {
+            Topic topic;
+            topic.title = slot->title;
+            topic.storageIndex = slot->storageIndex;
+            course.topics.append(topic);
+        }
+    }
+    return course;
+}
+
+QSharedPointer<SharedCourse::TopicSlot> SharedCourse::makeLoadedSlot(const Topic& topic) {
+    auto loaded = QSharedPointer<Topic>::create(topic);
+    loaded->storageIndex = -1;
+
+    auto slot = QSharedPointer<TopicSlot>::create();
+    slot->title = topic.title;
+    slot->loaded = loaded;
+    return slot;
+}
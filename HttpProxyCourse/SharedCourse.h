@@ -0,0 +1,195 @@
+#pragma once
+
+#include "DomainTypes.h"
+#include <QMutex>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+class SharedCourse;
+
+/// @brief Разделяемый неизменяемый снимок курса.
+using SharedCoursePtr = QSharedPointer<const SharedCourse>;
+
+/**
+ * @brief Неизменяемый снимок курса, общий для всех владельцев.
+ *
+ * CourseModel, SessionManager, AppController, TestWidget и AdminWidget держат
+ * один и тот же снимок по SharedCoursePtr вместо собственных копий Course.
+ * Тело темы подгружается из файла курса один раз и становится общим для всех
+ * снимков, разделяющих эту тему. Изменение создает новый снимок (копирование
+ * при записи на уровне темы): неизмененные темы разделяются со старым снимком.
+ */
+class SharedCourse {
+public:
+    /**
+     * @brief Создает снимок из курса, загруженного Serializer::load().
+     * @param course Курс; незагруженные темы подгружаются из course.storage.
+     */
+    explicit SharedCourse(const Course& course);
+
+    /**
+     * @brief Загружает курс из файла в новый снимок.
+     * @param filePath Полный путь к файлу.
+     * @throws std::runtime_error Если файл не открылся или данные повреждены.
+     */
+    static SharedCoursePtr load(const QString& filePath);
+
+    /**
+     * @brief Загружает курс из файла, а при неудаче — встроенный курс по умолчанию.
+     * @param filePath Полный путь к файлу.
+     * @see Serializer::loadOrDefault()
+     */
+    static SharedCoursePtr loadOrDefault(const QString& filePath);
+
+    /**
+     * @brief Возвращает количество тем.
+     */
+    int topicCount() const { return m_topics.size(); }
+
+    /**
+     * @brief Возвращает название темы без загрузки ее тела.
+     * @param index Индекс темы (0-based).
+     */
+    const QString& topicTitle(int index) const;
+
+    /**
+     * @brief Возвращает названия всех тем.
+     */
+    QStringList topicTitles() const;
+
+    /**
+     * @brief Возвращает тему, при первом обращении подгружая ее теорию и вопросы.
+     * @param index Индекс темы (0-based).
+     * @return Тема, общая для всех снимков, которые ее разделяют.
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    TopicPtr topic(int index) const;
+
+    /**
+     * @brief Возвращает тему, только если ее тело уже загружено (без чтения файла).
+     * @param index Индекс темы (0-based).
+     * @return Загруженная тема или nullptr.
+     */
+    TopicPtr loadedTopic(int index) const;
+
+    /**
+     * @brief Проверяет, разделяют ли снимки тему с указанным индексом.
+     *
+     * Снимки, полученные друг из друга правкой, разделяют неизмененные темы,
+     * поэтому сравнение указателей находит измененные темы без их загрузки.
+     *
+     * @param other Другой снимок.
+     * @param index Индекс темы (0-based), действительный в обоих снимках.
+     */
+    bool sharesTopic(const SharedCourse& other, int index) const {
+        return m_topics[index] == other.m_topics[index];
+    }
+
+    /**
+     * @brief Возвращает данные ресурса (изображения) из контейнера курса.
+     * @param name Относительный путь ресурса, как в HTML теории.
+     * @return Данные поверх отображенной памяти; пустой массив, если ресурса нет
+     *         или курс не загружен из контейнера.
+     * @throws std::runtime_error Если данные ресурса повреждены.
+     */
+    QByteArray asset(const QString& name) const;
+
+    /**
+     * @brief Возвращает контейнер, из которого читаются темы и ресурсы (может быть nullptr).
+     *
+     * Снимки, полученные правкой одного курса, разделяют контейнер.
+     */
+    const CourseStorage* storage() const { return m_storage.data(); }
+
+    /**
+     * @brief Декодирует тему, не оставляя ее тело в снимке.
+     *
+     * Уже загруженная тема возвращается как есть; иначе тело читается из
+     * контейнера во временный объект, который освобождается вместе с
+     * результатом. Подходит для однократного прохода по всем темам
+     * (проверка, индексация), не нарушая ленивую загрузку.
+     *
+     * @param index Индекс темы (0-based).
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    TopicPtr readTopic(int index, ValidationReport* report = nullptr) const;
+
+    /**
+     * @brief Декодирует и проверяет тела всех еще не загруженных тем в пуле потоков.
+     *
+     * Темы декодируются пачками по TopicsPerPreloadTask в CourseSnapshot: строки
+     * пачки лежат в одной арене, которая после проверки освобождается целиком,
+     * поэтому в памяти остаются только темы, открытые пользователем. Отчеты
+     * потоков объединяются в одну сводку; темы, которые не удалось
+     * декодировать, попадают в ValidationReport::failedTopics.
+     *
+     * @return Сводка проверки всех тем.
+     */
+    ValidationReport preloadAll() const;
+
+    /**
+     * @brief Запускает preloadAll() в фоне и выводит сводку проверки в журнал.
+     * @param course Снимок курса; удерживается до окончания загрузки.
+     */
+    static void preloadInBackground(const SharedCoursePtr& course);
+
+    /**
+     * @brief Возвращает новый снимок, в котором заменена одна тема.
+     * @param index Индекс темы (0-based).
+     * @param topic Новое содержимое темы.
+     * @throws std::runtime_error Если индекс неверный.
+     */
+    SharedCoursePtr withTopic(int index, const Topic& topic) const;
+
+    /**
+     * @brief Возвращает новый снимок с темой, добавленной в конец.
+     */
+    SharedCoursePtr withAppendedTopic(const Topic& topic) const;
+
+    /**
+     * @brief Возвращает новый снимок без указанной темы.
+     * @throws std::runtime_error Если индекс неверный.
+     */
+    SharedCoursePtr withoutTopic(int index) const;
+
+    /**
+     * @brief Собирает Course для Serializer (тела тем не копируются: строки Qt разделяются).
+     *
+     * Незагруженные темы передаются без тела, со ссылкой на исходный контейнер.
+     */
+    Course toCourse() const;
+
+private:
+    /**
+     * @brief Ячейка темы; разделяется между снимками, пока тема не изменена.
+     */
+    struct TopicSlot {
+        QString title;             ///< Название темы
+        qint32 storageIndex = -1;  ///< Индекс блока в контейнере, пока тело не загружено
+        QMutex mutex;              ///< Защищает однократную загрузку тела
+        TopicPtr loaded;           ///< Загруженная тема
+    };
+
+    /// @brief Число тем, которые одна задача preloadAll() декодирует в общую арену.
+    static constexpr int TopicsPerPreloadTask = 64;
+
+    SharedCourse(const SharedCourse&) = default;
+
+    /**
+     * @brief Загружает тело темы в ячейку, если оно еще не загружено.
+     * @param index Индекс темы (0-based).
+     * @param report Сводка проверки вопросов (может быть nullptr).
+     * @throws std::runtime_error Если индекс неверный или блок темы поврежден.
+     */
+    TopicPtr loadSlot(int index, ValidationReport* report) const;
+
+    /**
+     * @brief Создает ячейку для уже загруженной темы.
+     */
+    static QSharedPointer<TopicSlot> makeLoadedSlot(const Topic& topic);
+
+    QVector<QSharedPointer<TopicSlot>> m_topics;  ///< Темы курса
+    QSharedPointer<CourseStorage> m_storage;      ///< Контейнер, из которого подгружаются тела тем
+};
@@ -1,8 +1,8 @@
 #include "StudentProfileWidget.h"
 #include "TestResultDao.h"
 #include "DatabaseManager.h"
-#include <QSqlQuery>
-#include <QSqlError>
+#include "DbExecutor.h"
+#include "TestResultQueue.h"
 #include <QMessageBox>
 #include <QDebug>
 #include <QFont>
@@ -47,7 +47,7 @@ StudentProfileWidget::StudentProfileWidget(QWidget *parent)
     connect(m_refreshButton, &QPushButton::clicked, this, &StudentProfileWidget::onRefreshClicked);
     
     // Инициализация модели
-    m_testHistoryModel = new QSqlQueryModel(this);
+    m_testHistoryModel = new QStandardItemModel(this);
 }
 
 void StudentProfileWidget::setCurrentUser(const User& user) {
@@ -72,8 +72,7 @@ void StudentProfileWidget::refreshData() {
     }
     
     updateUserInfo();
-    updateStatistics();
-    updateTestHistory();
+    loadResults();
 }
 
 void StudentProfileWidget::onBackClicked() {
@@ -175,7 +174,43 @@ void StudentProfileWidget::updateUserInfo() {
     m_userRoleLabel->setText(roleText);
 }
 
-void StudentProfileWidget::updateStatistics() {
+void StudentProfileWidget::loadResults() {
+    if (!m_currentUser.isValid() || !DatabaseManager::instance().isConnected()) {
+        updateStatistics(ProfileResults());
+        updateTestHistory(QList<TestResult>());
+        return;
+    }
+
+    // Все запросы профиля выполняются одной задачей в пуле потоков БД
+    const int userId = m_currentUser.id;
+    QFuture<bool> queued = TestResultQueue::instance().flush();
+    QFuture<ProfileResults> future = DbExecutor::run([userId, queued]() {
+        // Только что завершенный тест должен попасть в статистику
+        if (!queued.result()) {
+            qWarning() << "Profile statistics may miss test results that are not saved yet";
+        }
+
+        ProfileResults data;
+        data.results = TestResultDao::findByUserId(userId);
+        if (!data.results.isEmpty()) {
+            data.averageScore = TestResultDao::getAverageScore(userId);
+            data.bestResult = TestResultDao::getBestResult(userId);
+        }
+        return data;
+    });
+
+    m_refreshButton->setEnabled(false);
+    DbExecutor::then(this, future, [this, userId](const ProfileResults& data) {
+        m_refreshButton->setEnabled(true);
+        if (m_currentUser.id != userId) {
+            return; // Пока шел запрос, профиль переключили на другого пользователя
+        }
+        updateStatistics(data);
+        updateTestHistory(data.results);
+    });
+}
+
+void StudentProfileWidget::updateStatistics(const ProfileResults& data) {
     if (!m_currentUser.isValid()) {
         m_totalTestsLabel->setText("—");
         m_averageScoreLabel->setText("—");
@@ -184,24 +219,17 @@ void StudentProfileWidget::updateStatistics() {
         return;
     }
     
-    // Получение статистики через DAO
-    QList<TestResult> results = TestResultDao::findByUserId(m_currentUser.id);
-    int totalTests = results.size();
-    
+    int totalTests = data.results.size();
     m_totalTestsLabel->setText(QString::number(totalTests));
     
     if (totalTests > 0) {
-        // Вычисление средней оценки
-        double avgPercentage = TestResultDao::getAverageScore(m_currentUser.id);
-        
-        // Поиск лучшего результата
-        TestResult bestResult = TestResultDao::getBestResult(m_currentUser.id);
-        double bestPercentage = bestResult.getPercentage();
+        // Лучший результат и средний балл посчитаны запросами к БД
+        double bestPercentage = data.bestResult.getPercentage();
         
         // Последний тест (первый в списке, так как отсортирован по дате DESC)
-        QDateTime lastTestDate = results.first().testDate;
+        QDateTime lastTestDate = data.results.first().testDate;
         
-        m_averageScoreLabel->setText(QString("%1%").arg(avgPercentage, 0, 'f', 1));
+        m_averageScoreLabel->setText(QString("%1%").arg(data.averageScore, 0, 'f', 1));
         m_bestScoreLabel->setText(QString("%1%").arg(bestPercentage, 0, 'f', 1));
         m_lastTestLabel->setText(lastTestDate.toString("dd.MM.yyyy hh:mm"));
     } else {
@@ -211,46 +239,26 @@ void StudentProfileWidget::updateStatistics() {
     }
 }
 
-void StudentProfileWidget::updateTestHistory() {
-    if (!m_currentUser.isValid() || !DatabaseManager::instance().isConnected()) {
-        m_testHistoryModel->clear();
-        return;
-    }
-    
-    // SQL запрос для истории тестов
-    QString queryString = 
-        "SELECT "
-            "id as \"ID\", "
-            "test_date as \"Дата и время\", "
-            "score as \"Набрано баллов\", "
-            "max_score as \"Максимум баллов\", "
-            "ROUND(CAST(score AS FLOAT) / CAST(max_score AS FLOAT) * 100, 1) as \"Процент (%)\" "
-        "FROM test_results "
-        "WHERE user_id = ? "
-        "ORDER BY test_date DESC";
-    
-    // Подготовка запроса с параметром
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(queryString);
-    query.addBindValue(m_currentUser.id);
-    
-    if (!query.exec()) {
-        qCritical() << "Failed to fetch test history:" << query.lastError().text();
-        QMessageBox::warning(this, "Ошибка", "Не удалось загрузить историю тестов.");
-        return;
+void StudentProfileWidget::updateTestHistory(const QList<TestResult>& results) {
+    m_testHistoryModel->clear();
+    m_testHistoryModel->setHorizontalHeaderLabels(
+        { "ID", "Дата и время", "Набрано баллов", "Максимум баллов", "Процент (%)" });
+
+    for (const TestResult& result : results) {
+        const QVariant values[] = { result.id, result.testDate, result.score, result.maxScore,
+                                    qRound(result.getPercentage() * 10) / 10.0 };
+        QList<QStandardItem*> row;
+        for (const QVariant& value : values) {
+            QStandardItem* item = new QStandardItem();
+            item->setData(value, Qt::DisplayRole);
+            item->setEditable(false);
+            row << item;
+        }
+        m_testHistoryModel->appendRow(row);
     }
-    
-    // Установка модели
-    m_testHistoryModel->setQuery(query);
+
     m_testHistoryTable->setModel(m_testHistoryModel);
     
-    // Проверка на ошибки модели
-    if (m_testHistoryModel->lastError().isValid()) {
-        qCritical() << "Model error:" << m_testHistoryModel->lastError().text();
-        QMessageBox::warning(this, "Ошибка", "Ошибка при отображении данных.");
-        return;
-    }
-    
     // Настройка размеров колонок
     m_testHistoryTable->resizeColumnsToContents();
     
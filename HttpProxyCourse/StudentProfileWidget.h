@@ -1,23 +1,24 @@
 #pragma once
 
 #include "DomainTypes.h"
+#include "TestResultDao.h"
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QTableView>
 #include <QPushButton>
-#include <QSqlQueryModel>
+#include <QStandardItemModel>
 #include <QHeaderView>
 #include <QGroupBox>
 #include <QGridLayout>
-#include <QSqlQuery>
 
 /**
  * @brief Виджет профиля студента с историей тестирования.
  * 
  * Отображает информацию о пользователе и историю его тестов
- * с использованием QTableView и QSqlQueryModel.
+ * с использованием QTableView. Результаты загружаются одним фоновым
+ * запросом (TestResultDao), поэтому открытие профиля не ждет сервер БД.
  */
 class StudentProfileWidget : public QWidget {
     Q_OBJECT
@@ -42,7 +43,7 @@ public:
     void setUser(const User& user);
 
     /**
-     * @brief Обновляет данные профиля и историю тестов.
+     * @brief Обновляет данные профиля и запускает загрузку истории тестов.
      */
     void refreshData();
 
@@ -90,15 +91,31 @@ private:
      */
     void updateUserInfo();
 
+    /**
+     * @brief Статистика и история тестов, загруженные в фоне.
+     */
+    struct ProfileResults {
+        QList<TestResult> results;  ///< Результаты (новые первыми)
+        double averageScore = 0.0;  ///< Средний процент
+        TestResult bestResult;      ///< Лучший результат
+    };
+
+    /**
+     * @brief Запускает фоновую загрузку результатов текущего пользователя.
+     */
+    void loadResults();
+
     /**
      * @brief Обновляет статистику пользователя.
+     * @param data Загруженные результаты.
      */
-    void updateStatistics();
+    void updateStatistics(const ProfileResults& data);
 
     /**
      * @brief Обновляет историю тестов.
+     * @param results Результаты (новые первыми).
      */
-    void updateTestHistory();
+    void updateTestHistory(const QList<TestResult>& results);
 
     // Текущий пользователь
     User m_currentUser;
@@ -116,7 +133,7 @@ private:
 
     // UI элементы - история тестов
     QTableView* m_testHistoryTable;
-    QSqlQueryModel* m_testHistoryModel;
+    QStandardItemModel* m_testHistoryModel;
 
     // Кнопки управления
     QPushButton* m_backButton;
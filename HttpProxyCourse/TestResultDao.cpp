@@ -1,7 +1,9 @@
 #include "TestResultDao.h"
 #include "DatabaseManager.h"
+#include "DbExecutor.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QStringList>
 #include <QDebug>
 
 bool TestResultDao::save(const TestResult& result) {
@@ -11,8 +13,7 @@ bool TestResultDao::save(const TestResult& result) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("INSERT INTO test_results (user_id, test_date, score, max_score) VALUES (?, ?, ?, ?)");
+    QSqlQuery query = dbManager.preparedQuery("INSERT INTO test_results (user_id, test_date, score, max_score) VALUES (?, ?, ?, ?)");
     query.addBindValue(result.userId);
     query.addBindValue(result.testDate);
     query.addBindValue(result.score);
@@ -28,6 +29,78 @@ bool TestResultDao::save(const TestResult& result) {
     return true;
 }
 
+namespace {
+
+/**
+ * @brief Определяет, вызвана ли ошибка самими данными (SQLSTATE классов 22 и 23).
+ *
+ * Такие ошибки (нарушение внешнего ключа, недопустимое значение) повторяются
+ * при каждой попытке, в отличие от обрыва соединения или перегрузки сервера.
+ */
+bool isDataError(const QSqlError& error) {
+    const QString state = error.nativeErrorCode();
+    return error.type() != QSqlError::ConnectionError
+        && (state.startsWith(QLatin1String("22")) || state.startsWith(QLatin1String("23")));
+}
+
+} // namespace
+
+TestResultDao::BatchResult TestResultDao::saveBatch(const QList<TestResult>& results) {
+    if (results.isEmpty()) {
+        return BatchResult::Saved;
+    }
+
+    DatabaseManager& dbManager = DatabaseManager::instance();
+    if (!dbManager.isConnected()) {
+        qWarning() << "Database not connected in TestResultDao::saveBatch";
+        return BatchResult::TransientError;
+    }
+
+    QSqlDatabase db = dbManager.database();
+    if (!db.transaction()) {
+        qCritical() << "Failed to start test results transaction:" << db.lastError().text();
+        return BatchResult::TransientError;
+    }
+
+    for (int first = 0; first < results.size(); first += MaxBatchRows) {
+        const int count = qMin(MaxBatchRows, results.size() - first);
+
+        // Текст зависит от числа строк, поэтому запрос не берется из кэша подготовленных
+        QStringList rows;
+        rows.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            rows << "(?, ?, ?, ?)";
+        }
+        QSqlQuery query(db);
+        query.prepare(QString("INSERT INTO test_results (user_id, test_date, score, max_score) VALUES %1")
+                          .arg(rows.join(", ")));
+
+        for (int i = first; i < first + count; ++i) {
+            query.addBindValue(results[i].userId);
+            query.addBindValue(results[i].testDate);
+            query.addBindValue(results[i].score);
+            query.addBindValue(results[i].maxScore);
+        }
+
+        if (!query.exec()) {
+            const QSqlError error = query.lastError();
+            qCritical() << "Failed to save test results batch:" << error.text();
+            db.rollback();
+            return isDataError(error) ? BatchResult::DataError : BatchResult::TransientError;
+        }
+    }
+
+    if (!db.commit()) {
+        const QSqlError error = db.lastError();
+        qCritical() << "Failed to commit test results batch:" << error.text();
+        db.rollback();
+        return isDataError(error) ? BatchResult::DataError : BatchResult::TransientError;
+    }
+
+    qDebug() << "Test results batch saved:" << results.size() << "results";
+    return BatchResult::Saved;
+}
+
 QList<TestResult> TestResultDao::findByUserId(int userId) {
     QList<TestResult> results;
     
@@ -37,8 +110,7 @@ QList<TestResult> TestResultDao::findByUserId(int userId) {
         return results;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT id, user_id, test_date, score, max_score FROM test_results WHERE user_id = ? ORDER BY test_date DESC");
+    QSqlQuery query = dbManager.preparedQuery("SELECT id, user_id, test_date, score, max_score FROM test_results WHERE user_id = ? ORDER BY test_date DESC");
     query.addBindValue(userId);
     
     if (!query.exec()) {
@@ -68,8 +140,7 @@ QList<TestResult> TestResultDao::findAll() {
         return results;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT id, user_id, test_date, score, max_score FROM test_results ORDER BY test_date DESC");
+    QSqlQuery query = dbManager.preparedQuery("SELECT id, user_id, test_date, score, max_score FROM test_results ORDER BY test_date DESC");
     
     if (!query.exec()) {
         qCritical() << "Failed to fetch all test results:" << query.lastError().text();
@@ -98,8 +169,7 @@ TestResult TestResultDao::getBestResult(int userId) {
         return bestResult;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare(R"(
+    QSqlQuery query = dbManager.preparedQuery(R"(
         SELECT id, user_id, test_date, score, max_score 
         FROM test_results 
         WHERE user_id = ? 
@@ -131,8 +201,7 @@ double TestResultDao::getAverageScore(int userId) {
         return 0.0;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare(R"(
+    QSqlQuery query = dbManager.preparedQuery(R"(
         SELECT AVG(CAST(score AS FLOAT) / max_score * 100) as avg_percentage 
         FROM test_results 
         WHERE user_id = ? AND max_score > 0
@@ -158,8 +227,7 @@ bool TestResultDao::deleteByUserId(int userId) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("DELETE FROM test_results WHERE user_id = ?");
+    QSqlQuery query = dbManager.preparedQuery("DELETE FROM test_results WHERE user_id = ?");
     query.addBindValue(userId);
     
     if (!query.exec()) {
@@ -168,4 +236,28 @@ bool TestResultDao::deleteByUserId(int userId) {
     }
     
     return query.numRowsAffected() > 0;
-}
\ No newline at end of file
+}
+
+QFuture<bool> TestResultDao::saveAsync(const TestResult& result) {
+    return DbExecutor::run([result]() { return save(result); });
+}
+
+QFuture<QList<TestResult>> TestResultDao::findByUserIdAsync(int userId) {
+    return DbExecutor::run([userId]() { return findByUserId(userId); });
+}
+
+QFuture<QList<TestResult>> TestResultDao::findAllAsync() {
+    return DbExecutor::run([]() { return findAll(); });
+}
+
+QFuture<TestResult> TestResultDao::getBestResultAsync(int userId) {
+    return DbExecutor::run([userId]() { return getBestResult(userId); });
+}
+
+QFuture<double> TestResultDao::getAverageScoreAsync(int userId) {
+    return DbExecutor::run([userId]() { return getAverageScore(userId); });
+}
+
+QFuture<bool> TestResultDao::deleteByUserIdAsync(int userId) {
+    return DbExecutor::run([userId]() { return deleteByUserId(userId); });
+}
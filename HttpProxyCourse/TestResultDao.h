@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QString>
+#include <QFuture>
 #include <QDateTime>
 #include <QList>
 
@@ -76,10 +77,53 @@ public:
      */
     static double getAverageScore(int userId);
 
+    /// @brief Наибольшее число строк в одном запросе saveBatch().
+    static constexpr int MaxBatchRows = 500;
+
+    /**
+     * @brief Результат пакетного сохранения.
+     */
+    enum class BatchResult {
+        Saved,          ///< Все результаты сохранены
+        TransientError, ///< Ошибка соединения или сервера; пачку можно повторить
+        DataError       ///< Данные пачки отвергнуты (ограничение целостности, недопустимое значение)
+    };
+
+    /**
+     * @brief Сохранить несколько результатов в одной транзакции.
+     *
+     * Результаты вставляются многострочными INSERT по MaxBatchRows строк;
+     * при ошибке транзакция откатывается и не сохраняется ни один результат.
+     *
+     * @param results Результаты тестов.
+     * @return Итог сохранения; при DataError повтор той же пачки снова не удастся.
+     */
+    static BatchResult saveBatch(const QList<TestResult>& results);
+
     /**
      * @brief Удалить все результаты пользователя.
      * @param userId ID пользователя.
      * @return true, если удаление прошло успешно.
      */
     static bool deleteByUserId(int userId);
+
+    // Асинхронные варианты: сохранение результата по окончании теста и
+    // статистика профиля загружаются без блокировки интерфейса.
+    /// @brief Асинхронный save().
+    static QFuture<bool> saveAsync(const TestResult& result);
+
+    /// @brief Асинхронный findByUserId().
+    static QFuture<QList<TestResult>> findByUserIdAsync(int userId);
+
+    /// @brief Асинхронный findAll().
+    static QFuture<QList<TestResult>> findAllAsync();
+
+    /// @brief Асинхронный getBestResult().
+    static QFuture<TestResult> getBestResultAsync(int userId);
+
+    /// @brief Асинхронный getAverageScore().
+    static QFuture<double> getAverageScoreAsync(int userId);
+
+    /// @brief Асинхронный deleteByUserId().
+    static QFuture<bool> deleteByUserIdAsync(int userId);
 };
\ No newline at end of file
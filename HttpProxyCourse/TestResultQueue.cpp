@@ -0,0 +1,169 @@
+#include "TestResultQueue.h"
+#include "DatabaseConfig.h"
+#include "DatabaseManager.h"
+#include "DbExecutor.h"
+#include <QFutureInterface>
+#include <QMutexLocker>
+#include <QDebug>
+
+TestResultQueue::TestResultQueue() {
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, [this]() { flush(); });
+}
+
+namespace {
+
+/**
+ * @brief Возвращает уже завершенный future с заданным результатом.
+ */
+QFuture<bool> readyFuture(bool value) {
+    QFutureInterface<bool> ready;
+    ready.reportStarted();
+    ready.reportResult(value);
+    ready.reportFinished();
+    return ready.future();
+}
+
+} // namespace
+
+TestResultQueue& TestResultQueue::instance() {
+    static TestResultQueue instance;
+    return instance;
+}
+
+void TestResultQueue::enqueue(const TestResult& result) {
+    bool full = false;
+    bool overflow = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.append(result);
+        full = m_pending.size() >= TestResultDao::MaxBatchRows;
+
+        // Без соединения с БД очередь не растет без предела
+        overflow = m_pending.size() > MaxPendingResults;
+        if (overflow) {
+            m_pending.removeFirst();
+        }
+    }
+    if (overflow) {
+        qCritical() << "Test result queue is full, dropped the oldest result";
+    }
+
+    if (full) {
+        flush();
+    } else {
+        scheduleFlush();
+    }
+}
+
+QFuture<bool> TestResultQueue::flush() {
+    QMutexLocker locker(&m_mutex);
+
+    // Завершенные пачки больше не нужны для ожидания
+    for (int i = m_inFlight.size() - 1; i >= 0; --i) {
+        if (m_inFlight[i].isFinished()) {
+            m_inFlight.removeAt(i);
+        }
+    }
+
+    if (!m_pending.isEmpty() && DatabaseManager::instance().isConnected()) {
+        QList<TestResult> batch;
+        batch.swap(m_pending);
+        m_inFlight.append(DbExecutor::run([this, batch]() { return writeBatch(batch); }));
+    }
+
+    if (m_inFlight.isEmpty()) {
+        return readyFuture(m_pending.isEmpty());
+    }
+    if (m_inFlight.size() == 1 && m_pending.isEmpty()) {
+        return m_inFlight.first();
+    }
+
+    // Результаты могли уйти в пачки, отправленные раньше таймером или по заполнению очереди
+    const QList<QFuture<bool>> batches = m_inFlight;
+    const bool allSent = m_pending.isEmpty();
+    return DbExecutor::run([batches, allSent]() {
+        bool saved = allSent;
+        for (QFuture<bool> batch : batches) {
+            batch.waitForFinished();
+            saved = batch.result() && saved;
+        }
+        return saved;
+    });
+}
+
+void TestResultQueue::shutdown() {
+    m_flushTimer.stop();
+
+    // Вторая попытка забирает результаты, возвращенные в очередь после ошибки соединения
+    if (!flush().result()) {
+        flush().waitForFinished();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending.isEmpty()) {
+        qWarning() << m_pending.size() << "test results were not saved to the database";
+    }
+}
+
+bool TestResultQueue::writeBatch(const QList<TestResult>& batch) {
+    QList<TestResult> retry;
+    int dropped = 0;
+
+    switch (TestResultDao::saveBatch(batch)) {
+    case TestResultDao::BatchResult::Saved:
+        return true;
+    case TestResultDao::BatchResult::TransientError:
+        retry = batch;
+        break;
+    case TestResultDao::BatchResult::DataError:
+        // Одна отвергнутая строка не должна блокировать остальные: пачка пишется по строкам
+        for (const TestResult& result : batch) {
+            switch (TestResultDao::saveBatch({ result })) {
+            case TestResultDao::BatchResult::Saved:
+                break;
+            case TestResultDao::BatchResult::TransientError:
+                retry.append(result);
+                break;
+            case TestResultDao::BatchResult::DataError:
+                ++dropped;
+                qCritical() << "Dropping test result rejected by the database: user" << result.userId
+                            << "date" << result.testDate << "score" << result.score << "/" << result.maxScore;
+                break;
+            }
+        }
+        break;
+    }
+
+    if (!retry.isEmpty()) {
+        requeue(retry);
+    }
+    return retry.isEmpty() && dropped == 0;
+}
+
+void TestResultQueue::requeue(const QList<TestResult>& results) {
+    int overflow = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending = results + m_pending;
+
+        // При долгом обрыве соединения очередь не растет без предела: отбрасываются самые старые
+        overflow = m_pending.size() - MaxPendingResults;
+        if (overflow > 0) {
+            m_pending.erase(m_pending.begin(), m_pending.begin() + overflow);
+        }
+    }
+    if (overflow > 0) {
+        qCritical() << "Test result queue is full, dropped" << overflow << "oldest results";
+    }
+    scheduleFlush();
+}
+
+void TestResultQueue::scheduleFlush() {
+    // Таймер принадлежит потоку очереди; результаты могут приходить из любого потока
+    QMetaObject::invokeMethod(this, [this]() {
+        if (!m_flushTimer.isActive()) {
+            m_flushTimer.start(DatabaseConfig::instance().resultFlushLatency());
+        }
+    });
+}
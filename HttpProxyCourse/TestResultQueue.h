@@ -0,0 +1,93 @@
+#pragma once
+
+#include "TestResultDao.h"
+#include <QObject>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QTimer>
+
+/**
+ * @brief Очередь записи результатов тестов.
+ *
+ * Когда группа одновременно завершает тест, результаты не вставляются по
+ * одному, а собираются в очередь и записываются пачкой в одной транзакции
+ * (TestResultDao::saveBatch). Пачка отправляется, как только в очереди
+ * набирается TestResultDao::MaxBatchRows результатов, и не позже чем через
+ * DatabaseConfig::resultFlushLatency() мс после первого результата в очереди.
+ *
+ * Запись выполняется в пуле потоков БД; пачки независимы, поэтому несколько
+ * пачек могут записываться одновременно. Пачка, которую не удалось записать
+ * из-за соединения, возвращается в очередь (не больше MaxPendingResults
+ * результатов). Если сервер отверг данные пачки, она записывается по одной
+ * строке, и отвергнутые строки отбрасываются с записью в журнал. flush()
+ * вызывается при выходе пользователя, shutdown() — при завершении приложения.
+ */
+class TestResultQueue : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Наибольшее число результатов в очереди; при переполнении отбрасываются самые старые.
+    static constexpr int MaxPendingResults = 20 * TestResultDao::MaxBatchRows;
+
+    /**
+     * @brief Получить единственный экземпляр TestResultQueue.
+     * @return Ссылка на экземпляр.
+     */
+    static TestResultQueue& instance();
+
+    /**
+     * @brief Поставить результат в очередь на запись.
+     * @param result Результат теста.
+     */
+    void enqueue(const TestResult& result);
+
+    /**
+     * @brief Немедленно отправить накопленные результаты на запись.
+     * @return Future, завершающийся после записи этих результатов и всех пачек,
+     *         отправленных раньше; результат true, если все они сохранены.
+     *         Если БД не подключена, результаты остаются в очереди (false).
+     */
+    QFuture<bool> flush();
+
+    /**
+     * @brief Дождаться записи всех результатов, включая уже отправленные пачки.
+     * Вызывается при завершении приложения, пока пул соединений еще работает.
+     */
+    void shutdown();
+
+private:
+    /**
+     * @brief Приватный конструктор для реализации паттерна Singleton.
+     */
+    TestResultQueue();
+
+    /**
+     * @brief Запретить копирование.
+     */
+    TestResultQueue(const TestResultQueue&) = delete;
+    TestResultQueue& operator=(const TestResultQueue&) = delete;
+
+    /**
+     * @brief Записать пачку; выполняется в пуле потоков БД.
+     * @param batch Результаты пачки.
+     * @return true, если сохранены все результаты пачки.
+     */
+    bool writeBatch(const QList<TestResult>& batch);
+
+    /**
+     * @brief Вернуть результаты в начало очереди с ограничением ее размера.
+     * @param results Результаты, которые не удалось записать из-за соединения.
+     */
+    void requeue(const QList<TestResult>& results);
+
+    /**
+     * @brief Запустить таймер задержки в потоке очереди, если он не запущен.
+     */
+    void scheduleFlush();
+
+    QMutex m_mutex;                    ///< Защищает m_pending и m_inFlight
+    QList<TestResult> m_pending;       ///< Результаты, ожидающие записи
+    QList<QFuture<bool>> m_inFlight;   ///< Пачки, которые записываются сейчас
+    QTimer m_flushTimer;               ///< Ограничение задержки записи
+};
@@ -1,6 +1,7 @@
 #include "TestWidget.h"
 #include "TestResultDao.h"
 #include "DatabaseManager.h"
+#include "TestResultQueue.h"
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QSqlQuery>
@@ -95,8 +96,8 @@ int TestWidget::getSelectedVariantIndex() {
     return -1;
 }
 
-void TestWidget::startTest(const QList<Question>& questions, const User& user, int timeLimit) {
-    m_questions = questions;
+void TestWidget::startTest(const TopicPtr& topic, const User& user, int timeLimit) {
+    m_topic = topic;
     m_currentUser = user;
     m_timeLimitMinutes = timeLimit;
     m_currentQuestionIndex = 0;
@@ -105,7 +106,7 @@ void TestWidget::startTest(const QList<Question>& questions, const User& user, i
     m_testStartTime = QDateTime::currentDateTime();
 
     // Настройка прогресс-бара
-    m_progressBar->setMaximum(m_questions.size());
+    m_progressBar->setMaximum(questions().size());
     m_progressBar->setValue(0);
     m_progressBar->setVisible(true);
 
@@ -134,9 +135,9 @@ void TestWidget::finishTest() {
     saveTestResult();
 
     // Отправка сигнала о завершении
-    emit testFinished(m_correctAnswers, m_questions.size(), timeExpired);
+    emit testFinished(m_correctAnswers, questions().size(), timeExpired);
 
-    qDebug() << "Test finished. Score:" << m_correctAnswers << "/" << m_questions.size();
+    qDebug() << "Test finished. Score:" << m_correctAnswers << "/" << questions().size();
 }
 
 int TestWidget::getCurrentScore() const {
@@ -144,7 +145,7 @@ int TestWidget::getCurrentScore() const {
 }
 
 int TestWidget::getMaxScore() const {
-    return m_questions.size();
+    return questions().size();
 }
 
 void TestWidget::onTimeExpired() {
@@ -190,7 +191,7 @@ void TestWidget::onAnswerSubmitted() {
     }
 
     // Проверка правильности ответа
-    const Question& currentQuestion = m_questions[m_currentQuestionIndex];
+    const Question& currentQuestion = questions()[m_currentQuestionIndex];
     if (selectedIndex == currentQuestion.correctIndex) {
         m_correctAnswers++;
     }
@@ -198,7 +199,7 @@ void TestWidget::onAnswerSubmitted() {
     m_currentQuestionIndex++;
     updateProgress();
 
-    if (m_currentQuestionIndex >= m_questions.size()) {
+    if (m_currentQuestionIndex >= questions().size()) {
         finishTest();
     } else {
         showNextQuestion();
@@ -208,43 +209,43 @@ void TestWidget::onAnswerSubmitted() {
     emit answerSubmitted(selectedIndex);
 }
 
-bool TestWidget::saveTestResult() {
+void TestWidget::saveTestResult() {
     if (!m_currentUser.isValid()) {
         qWarning() << "Cannot save test result: invalid user";
-        return false;
+        return;
     }
 
     // Создание объекта результата теста
-    TestResult result(m_currentUser.id, m_correctAnswers, m_questions.size());
+    TestResult result(m_currentUser.id, m_correctAnswers, questions().size());
     
-    // Сохранение через DAO
-    if (!TestResultDao::save(result)) {
-        qCritical() << "Failed to save test result through DAO";
-        return false;
-    }
-
-    qDebug() << "Test result saved for user" << m_currentUser.login 
-             << "score:" << m_correctAnswers << "/" << m_questions.size();
-    return true;
+    // Результат записывается в БД пачкой вместе с результатами других студентов
+    TestResultQueue::instance().enqueue(result);
+    qDebug() << "Test result queued for user" << m_currentUser.login
+             << "score:" << result.score << "/" << result.maxScore;
 }
 
 void TestWidget::updateProgress() {
     m_progressLabel->setText(QString("Вопрос: %1/%2")
                             .arg(m_currentQuestionIndex + 1)
-                            .arg(m_questions.size()));
+                            .arg(questions().size()));
     
     m_progressBar->setValue(m_currentQuestionIndex);
 }
 
 void TestWidget::showNextQuestion() {
-    if (m_currentQuestionIndex < m_questions.size()) {
-        showQuestion(m_questions[m_currentQuestionIndex]);
+    if (m_currentQuestionIndex < questions().size()) {
+        showQuestion(questions()[m_currentQuestionIndex]);
         
         // Обновление текста кнопки для последнего вопроса
-        if (m_currentQuestionIndex == m_questions.size() - 1) {
+        if (m_currentQuestionIndex == questions().size() - 1) {
             btnAnswer->setText("Завершить тест");
         } else {
             btnAnswer->setText("Следующий вопрос");
         }
     }
 }
+
+const QList<Question>& TestWidget::questions() const {
+    static const QList<Question> empty;
+    return m_topic ? m_topic->questions : empty;
+}
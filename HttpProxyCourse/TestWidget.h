@@ -39,12 +39,12 @@ public:
     int getSelectedVariantIndex();
 
     /**
-     * @brief Начинает тест с указанными вопросами и пользователем.
-     * @param questions Список вопросов для тестирования.
+     * @brief Начинает тест по вопросам темы для указанного пользователя.
+     * @param topic Тема из общего снимка курса (вопросы не копируются).
      * @param user Пользователь, проходящий тест.
      * @param timeLimit Лимит времени в минутах (по умолчанию 20).
      */
-    void startTest(const QList<Question>& questions, const User& user, int timeLimit = 20);
+    void startTest(const TopicPtr& topic, const User& user, int timeLimit = 20);
 
     /**
      * @brief Завершает тест и сохраняет результаты.
@@ -96,10 +96,10 @@ private slots:
 
 private:
     /**
-     * @brief Сохраняет результат теста в базу данных.
-     * @return true, если результат сохранен успешно.
+     * @brief Ставит результат теста в очередь записи в базу данных.
+     * Результат записывается пачкой через TestResultQueue.
      */
-    bool saveTestResult();
+    void saveTestResult();
 
     /**
      * @brief Обновляет отображение прогресса.
@@ -111,6 +111,11 @@ private:
      */
     void showNextQuestion();
 
+    /**
+     * @brief Возвращает вопросы текущего теста (пустой список, если тест не начат).
+     */
+    const QList<Question>& questions() const;
+
     // UI элементы
     QLabel* questionLabel;
     QWidget* variantsContainer;
@@ -126,7 +131,7 @@ private:
     QLabel* m_progressLabel;
 
     // Данные теста
-    QList<Question> m_questions;
+    TopicPtr m_topic;            ///< Тема теста из общего снимка курса
     User m_currentUser;
     int m_currentQuestionIndex;
     int m_correctAnswers;
@@ -0,0 +1,248 @@
+#include "TopicDocument.h"
+#include "CourseAssetCache.h"
+#include <QTextBlock>
+#include <QTextCursor>
+
+namespace {
+
+/**
+ * @brief Блочные контейнеры, после закрытия которых можно разделить длинный раздел.
+ */
+bool isContainerTag(const QString& name) {
+    return name == QLatin1String("table") || name == QLatin1String("ul") || name == QLatin1String("ol")
+           || name == QLatin1String("dl") || name == QLatin1String("pre") || name == QLatin1String("blockquote");
+}
+
+/**
+ * @brief Элементы без содержимого и закрывающего тега.
+ */
+bool isVoidTag(const QString& name) {
+    static const QStringList voidTags = {
+        QStringLiteral("area"), QStringLiteral("base"), QStringLiteral("br"), QStringLiteral("col"),
+        QStringLiteral("embed"), QStringLiteral("hr"), QStringLiteral("img"), QStringLiteral("input"),
+        QStringLiteral("link"), QStringLiteral("meta"), QStringLiteral("param"), QStringLiteral("source"),
+        QStringLiteral("track"), QStringLiteral("wbr")
+    };
+    return voidTags.contains(name);
+}
+
+/**
+ * @brief Элементы, закрывающий тег которых можно опустить.
+ *
+ * Они не учитываются во вложенности: &lt;p&gt; не может содержать заголовок,
+ * а строки списков и таблиц лежат внутри учитываемых ul/ol/dl/table.
+ */
+bool isOptionalEndTag(const QString& name) {
+    static const QStringList optionalEndTags = {
+        QStringLiteral("p"), QStringLiteral("li"), QStringLiteral("dt"), QStringLiteral("dd"),
+        QStringLiteral("tr"), QStringLiteral("td"), QStringLiteral("th"), QStringLiteral("thead"),
+        QStringLiteral("tbody"), QStringLiteral("tfoot"), QStringLiteral("caption"), QStringLiteral("colgroup"),
+        QStringLiteral("option"), QStringLiteral("optgroup")
+    };
+    return optionalEndTags.contains(name);
+}
+
+/**
+ * @brief Заголовки, с которых начинается новый раздел.
+ */
+bool isSectionHeading(const QString& name) {
+    return name == QLatin1String("h1") || name == QLatin1String("h2") || name == QLatin1String("h3");
+}
+
+/**
+ * @brief Блочные элементы, после закрытия которых можно разделить длинный раздел.
+ */
+bool isBlockTag(const QString& name) {
+    return isContainerTag(name) || name == QLatin1String("p") || name == QLatin1String("div")
+           || name == QLatin1String("hr") || (name.size() == 2 && name[0] == QLatin1Char('h')
+                                             && name[1] >= QLatin1Char('1') && name[1] <= QLatin1Char('6'));
+}
+
+/**
+ * @brief Возвращает позицию сразу за '>' тега, начинающегося в pos, с учетом кавычек.
+ */
+int tagEnd(const QString& html, int pos) {
+    QChar quote;
+    for (int i = pos + 1; i < html.size(); ++i) {
+        const QChar c = html[i];
+        if (!quote.isNull()) {
+            if (c == quote) {
+                quote = QChar();
+            }
+        } else if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            quote = c;
+        } else if (c == QLatin1Char('>')) {
+            return i + 1;
+        }
+    }
+    return html.size();
+}
+
+/**
+ * @brief Читает имя тега после '<' в нижнем регистре.
+ */
+QString tagName(const QString& html, int pos, bool* closing) {
+    *closing = pos < html.size() && html[pos] == QLatin1Char('/');
+    if (*closing) {
+        ++pos;
+    }
+    QString name;
+    while (pos < html.size() && html[pos].isLetterOrNumber() && html[pos].unicode() < 0x80) {
+        name.append(html[pos].toLower());
+        ++pos;
+    }
+    return name;
+}
+
+/**
+ * @brief Вырезает элементы &lt;style&gt; и возвращает их содержимое.
+ */
+QString takeStyleSheets(QString& html) {
+    QString styleSheet;
+    int pos = 0;
+    while ((pos = html.indexOf(QLatin1String("<style"), pos, Qt::CaseInsensitive)) >= 0) {
+        const int contentStart = tagEnd(html, pos);
+        int contentEnd = html.indexOf(QLatin1String("</style"), contentStart, Qt::CaseInsensitive);
+        if (contentEnd < 0) {
+            contentEnd = html.size();
+        }
+        styleSheet += html.mid(contentStart, contentEnd - contentStart) + QLatin1Char('\n');
+        const int elementEnd = contentEnd < html.size() ? tagEnd(html, contentEnd) : contentEnd;
+        html.remove(pos, elementEnd - pos);
+    }
+    return styleSheet;
+}
+
+/**
+ * @brief Возвращает содержимое &lt;body&gt; (или документ без &lt;head&gt;).
+ */
+QString bodyOf(const QString& html) {
+    const int body = html.indexOf(QLatin1String("<body"), 0, Qt::CaseInsensitive);
+    if (body >= 0) {
+        const int start = tagEnd(html, body);
+        const int end = html.indexOf(QLatin1String("</body"), start, Qt::CaseInsensitive);
+        return html.mid(start, end < 0 ? -1 : end - start);
+    }
+    const int headEnd = html.indexOf(QLatin1String("</head"), 0, Qt::CaseInsensitive);
+    return headEnd >= 0 ? html.mid(tagEnd(html, headEnd)) : html;
+}
+
+} // namespace
+
+TopicDocument::TopicDocument(const QString& html, const QFont& font, CourseAssetCache* assets, QObject* parent)
+    : QTextDocument(parent)
+    , m_assets(assets)
+{
+    setUndoRedoEnabled(false);
+    setDefaultFont(font);
+
+    QString styleSheet;
+    m_sections = splitSections(html, &styleSheet);
+    setDefaultStyleSheet(styleSheet);
+
+    // Первый раздел разбирается всегда, следующие — пока не исчерпан бюджет
+    QString initial;
+    while (hasPendingSections()
+           && (initial.isEmpty() || initial.size() + m_sections[m_nextSection].size() <= InitialSize)) {
+        initial += m_sections[m_nextSection++];
+    }
+    setHtml(initial);
+}
+
+bool TopicDocument::appendNextSection() {
+    if (!hasPendingSections()) {
+        return false;
+    }
+
+    QTextCursor cursor(this);
+    cursor.movePosition(QTextCursor::End);
+    if (cursor.block().length() > 1) {
+        cursor.insertBlock();
+    }
+    cursor.insertHtml(m_sections[m_nextSection++]);
+    return true;
+}
+
+QVariant TopicDocument::loadResource(int type, const QUrl& name) {
+    if (m_assets) {
+        const QVariant asset = m_assets->resource(type, name);
+        if (asset.isValid()) {
+            return asset;
+        }
+    }
+    return QTextDocument::loadResource(type, name);
+}
+
+QStringList TopicDocument::splitSections(const QString& html, QString* styleSheet) {
+    QString source = html;
+    const QString css = takeStyleSheets(source);
+    if (styleSheet) {
+        *styleSheet = css;
+    }
+    const QString body = bodyOf(source);
+
+    QStringList sections;
+    auto addSection = [&sections, &body](int begin, int end) {
+        const QString section = body.mid(begin, end - begin);
+        if (!section.trimmed().isEmpty()) {
+            sections.append(section);
+        } else if (!sections.isEmpty()) {
+            sections.last() += section;
+        }
+    };
+
+    // Раздел делится только на верхнем уровне: заголовок внутри div, font или span
+    // не должен разрывать обертку между разделами
+    int sectionStart = 0;
+    QStringList openTags;
+    int pos = 0;
+    while ((pos = body.indexOf(QLatin1Char('<'), pos)) >= 0) {
+        if (body.midRef(pos, 4) == QLatin1String("<!--")) {
+            const int end = body.indexOf(QLatin1String("-->"), pos + 4);
+            pos = end < 0 ? body.size() : end + 3;
+            continue;
+        }
+
+        const int tagStart = pos;
+        bool closing = false;
+        const QString name = tagName(body, pos + 1, &closing);
+        if (name.isEmpty()) {
+            ++pos;  // Одиночный '<' в тексте
+            continue;
+        }
+        pos = tagEnd(body, pos);
+
+        // Тег на верхнем уровне: открывающий — вне других элементов, закрывающий — закрывает внешний
+        bool topLevel = openTags.isEmpty();
+        if (closing) {
+            // Лишний закрывающий тег пропускается; пропущенные закрывающие теги
+            // вложенных элементов закрываются вместе с внешним
+            const int open = openTags.lastIndexOf(name);
+            if (open >= 0) {
+                openTags.erase(openTags.begin() + open, openTags.end());
+                topLevel = openTags.isEmpty();
+            }
+        } else if (!isVoidTag(name) && !isOptionalEndTag(name) && body[pos - 2] != QLatin1Char('/')) {
+            openTags.append(name);
+        }
+        if (!topLevel) {
+            continue;
+        }
+
+        if (!closing && isSectionHeading(name)) {
+            if (tagStart > sectionStart) {
+                addSection(sectionStart, tagStart);
+                sectionStart = tagStart;
+            }
+        } else if ((closing || name == QLatin1String("hr")) && isBlockTag(name)
+                   && pos - sectionStart >= MaxSectionSize) {
+            addSection(sectionStart, pos);
+            sectionStart = pos;
+        }
+    }
+
+    if (sectionStart < body.size()) {
+        addSection(sectionStart, body.size());
+    }
+    return sections;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QFont>
+#include <QString>
+#include <QStringList>
+#include <QTextDocument>
+#include <QUrl>
+#include <QVariant>
+
+class CourseAssetCache;
+
+/**
+ * @brief Документ теории, который строится по разделам.
+ *
+ * setHtml() разбирает и верстает весь HTML до первой отрисовки, поэтому
+ * на темах с большими таблицами и справочными разделами время открытия
+ * росло вместе с длиной темы. TopicDocument делит HTML на разделы по
+ * заголовкам h1–h3 (слишком длинные разделы — дополнительно по границам
+ * блоков верхнего уровня) и сразу разбирает только начало темы.
+ * Остальные разделы дописываются в конец через appendNextSection():
+ * TopicViewWidget делает это при прокрутке к концу и в простое.
+ *
+ * Таблицы стилей из &lt;style&gt; переносятся в defaultStyleSheet(),
+ * чтобы они применялись и к дописанным разделам.
+ *
+ * Документы строятся без родителя (заранее, для кэша), поэтому
+ * QTextBrowser::loadResource() к ним не применяется: изображения и другие
+ * ресурсы загружаются в loadResource() документа из контейнера курса.
+ */
+class TopicDocument : public QTextDocument {
+    Q_OBJECT
+
+public:
+    /// @brief Объем HTML, который разбирается до первой отрисовки (в символах).
+    static constexpr int InitialSize = 32 * 1024;
+
+    /// @brief Размер раздела, после которого он делится по границам блоков (в символах).
+    static constexpr int MaxSectionSize = 32 * 1024;
+
+    /**
+     * @brief Создает документ и разбирает начальные разделы темы.
+     * @param html HTML теории.
+     * @param font Шрифт по умолчанию.
+     * @param assets Ресурсы курса (может быть nullptr); должны пережить документ.
+     * @param parent Родительский объект.
+     */
+    TopicDocument(const QString& html, const QFont& font, CourseAssetCache* assets, QObject* parent = nullptr);
+
+    /**
+     * @brief Проверяет, остались ли неразобранные разделы.
+     */
+    bool hasPendingSections() const { return m_nextSection < m_sections.size(); }
+
+    /**
+     * @brief Дописывает в конец документа очередной раздел.
+     * @return false, если все разделы уже разобраны.
+     */
+    bool appendNextSection();
+
+    /**
+     * @brief Делит тело HTML на разделы.
+     *
+     * Граница раздела ставится только между элементами верхнего уровня, поэтому
+     * каждый раздел содержит целые элементы и разбирается отдельно без искажений.
+     *
+     * @param html HTML теории.
+     * @param styleSheet Сюда записываются таблицы стилей из &lt;style&gt;.
+     * @return Разделы в порядке следования; конкатенация дает тело документа.
+     */
+    static QStringList splitSections(const QString& html, QString* styleSheet);
+
+protected:
+    /**
+     * @brief Загружает ресурс из контейнера курса, иначе — стандартным способом.
+     */
+    QVariant loadResource(int type, const QUrl& name) override;
+
+private:
+    CourseAssetCache* m_assets;  ///< Ресурсы курса
+    QStringList m_sections;      ///< Разделы темы
+    int m_nextSection = 0;       ///< Индекс первого неразобранного раздела
+};
@@ -0,0 +1,140 @@
+#include "TopicDocumentCache.h"
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QDebug>
+
+TopicDocumentCache::TopicDocumentCache(CourseAssetCache* assets, int maxCost, QObject* parent)
+    : QObject(parent)
+    , m_assets(assets)
+    , m_cache(maxCost)
+{
+    m_prefetchTimer.setSingleShot(true);
+    m_prefetchTimer.setInterval(0);
+    connect(&m_prefetchTimer, &QTimer::timeout, this, &TopicDocumentCache::processPrefetchQueue);
+    connect(&m_decodeWatcher, &QFutureWatcher<TopicPtr>::finished, this, &TopicDocumentCache::onTopicDecoded);
+}
+
+QSharedPointer<TopicDocument> TopicDocumentCache::document(int topicIndex, const Topic& topic) {
+    const Key key = makeKey(topicIndex, topic);
+    if (QSharedPointer<TopicDocument>* cached = m_cache.object(key)) {
+        return *cached;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QSharedPointer<TopicDocument> document = build(topic);
+    qDebug() << "Topic document built on demand:" << topicIndex << "in" << timer.elapsed() << "ms";
+
+    m_cache.insert(key, new QSharedPointer<TopicDocument>(document), qMax(1, topic.htmlContent.size()));
+    return document;
+}
+
+void TopicDocumentCache::prefetch(int topicIndex, const SharedCoursePtr& course) {
+    if (!course || topicIndex < 0 || topicIndex >= course->topicCount()) {
+        return;
+    }
+    const TopicPtr loaded = course->loadedTopic(topicIndex);
+    if (loaded && m_cache.contains(makeKey(topicIndex, *loaded))) {
+        return;
+    }
+
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue[i].first == topicIndex) {
+            m_queue.removeAt(i);
+            break;
+        }
+    }
+
+    // Старые запросы отбрасываются: выделение в списке уже ушло дальше
+    m_queue.append(qMakePair(topicIndex, course));
+    while (m_queue.size() > MaxQueuedTopics) {
+        m_queue.removeFirst();
+    }
+
+    if (!m_prefetchTimer.isActive()) {
+        m_prefetchTimer.start();
+    }
+}
+
+void TopicDocumentCache::setLayoutParameters(const QFont& font, qreal textWidth) {
+    m_font = font;
+    m_textWidth = textWidth;
+}
+
+void TopicDocumentCache::clear() {
+    m_prefetchTimer.stop();
+    m_queue.clear();
+    m_cache.clear();
+
+    // Декодируемая сейчас тема относится к прежнему курсу и будет отброшена
+    ++m_generation;
+}
+
+void TopicDocumentCache::processPrefetchQueue() {
+    // Следующая тема берется из очереди, когда закончится декодирование текущей
+    if (m_queue.isEmpty() || m_decodeWatcher.isRunning()) {
+        return;
+    }
+
+    const QPair<int, SharedCoursePtr> entry = m_queue.takeFirst();
+    const int topicIndex = entry.first;
+    const SharedCoursePtr course = entry.second;
+
+    // Уже открытая тема не декодируется повторно
+    if (const TopicPtr loaded = course->loadedTopic(topicIndex)) {
+        insertPrefetched(topicIndex, *loaded);
+        if (!m_queue.isEmpty()) {
+            m_prefetchTimer.start();
+        }
+        return;
+    }
+
+    // Тело декодируется во временный объект и не остается в снимке курса
+    m_decodingIndex = topicIndex;
+    m_decodingGeneration = m_generation;
+    m_decodeWatcher.setFuture(QtConcurrent::run([course, topicIndex]() {
+        try {
+            return course->readTopic(topicIndex);
+        } catch (const std::exception& e) {
+            qWarning() << "Failed to prefetch topic" << topicIndex << ":" << e.what();
+            return TopicPtr();
+        }
+    }));
+}
+
+void TopicDocumentCache::onTopicDecoded() {
+    const TopicPtr topic = m_decodeWatcher.result();
+    if (topic && m_decodingGeneration == m_generation) {
+        insertPrefetched(m_decodingIndex, *topic);
+    }
+    m_decodingIndex = -1;
+
+    // По одному документу за итерацию, чтобы между ними обрабатывался ввод
+    if (!m_queue.isEmpty()) {
+        m_prefetchTimer.start();
+    }
+}
+
+void TopicDocumentCache::insertPrefetched(int topicIndex, const Topic& topic) {
+    if (topic.htmlContent.isEmpty()) {
+        return;
+    }
+    const Key key = makeKey(topicIndex, topic);
+    if (!m_cache.contains(key)) {
+        m_cache.insert(key, new QSharedPointer<TopicDocument>(build(topic)), qMax(1, topic.htmlContent.size()));
+    }
+}
+
+TopicDocumentCache::Key TopicDocumentCache::makeKey(int topicIndex, const Topic& topic) {
+    return qMakePair(topicIndex, qHash(topic.htmlContent));
+}
+
+QSharedPointer<TopicDocument> TopicDocumentCache::build(const Topic& topic) const {
+    QSharedPointer<TopicDocument> document(new TopicDocument(topic.htmlContent, m_font, m_assets));
+    if (m_textWidth > 0) {
+        // Запрос размера выполняет верстку на ширине области просмотра
+        document->setTextWidth(m_textWidth);
+        document->size();
+    }
+    return document;
+}
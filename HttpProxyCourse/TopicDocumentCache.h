@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CourseAssetCache.h"
+#include "DomainTypes.h"
+#include "SharedCourse.h"
+#include "TopicDocument.h"
+#include <QCache>
+#include <QFont>
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QSharedPointer>
+#include <QTimer>
+
+/**
+ * @brief LRU-кэш разобранных документов теории (TopicDocument) по темам.
+ *
+ * Разбор HTML и верстка при setHtml() на больших темах занимают сотни
+ * миллисекунд, поэтому TopicViewWidget показывает готовый документ из кэша.
+ * Ключ — индекс темы и хеш ее HTML: после правки темы документ строится заново.
+ * Документы соседних тем строятся заранее по одному за итерацию цикла
+ * событий: тело темы декодируется в пуле потоков во временный объект
+ * (SharedCourse::readTopic()) и не остается в снимке курса, а в главном
+ * потоке строится только документ.
+ *
+ * Документы разделяются через QSharedPointer: вытеснение из кэша не удаляет
+ * документ, который в данный момент показан.
+ */
+class TopicDocumentCache : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Суммарный объем HTML документов в кэше по умолчанию (в символах).
+    static constexpr int DefaultMaxCost = 16 * 1024 * 1024;
+
+    /**
+     * @brief Создает кэш.
+     * @param assets Ресурсы курса для документов (может быть nullptr); должны пережить кэш.
+     * @param maxCost Предельный суммарный объем HTML документов (в символах).
+     * @param parent Родительский объект.
+     */
+    explicit TopicDocumentCache(CourseAssetCache* assets, int maxCost = DefaultMaxCost, QObject* parent = nullptr);
+
+    /**
+     * @brief Возвращает документ темы, строя его при отсутствии в кэше.
+     * @param topicIndex Индекс темы.
+     * @param topic Тема с загруженной теорией.
+     */
+    QSharedPointer<TopicDocument> document(int topicIndex, const Topic& topic);
+
+    /**
+     * @brief Ставит тему в очередь на построение документа в фоне.
+     * @param topicIndex Индекс темы в снимке.
+     * @param course Снимок курса; удерживается, пока тема в очереди.
+     */
+    void prefetch(int topicIndex, const SharedCoursePtr& course);
+
+    /**
+     * @brief Задает шрифт и ширину текста, с которыми документы верстаются заранее.
+     * @param font Шрифт виджета просмотра.
+     * @param textWidth Ширина области просмотра; 0 — верстка откладывается до показа.
+     */
+    void setLayoutParameters(const QFont& font, qreal textWidth);
+
+    /**
+     * @brief Очищает кэш и очередь предварительной загрузки.
+     */
+    void clear();
+
+private slots:
+    /**
+     * @brief Запускает декодирование очередной темы из очереди.
+     */
+    void processPrefetchQueue();
+
+    /**
+     * @brief Строит документ декодированной темы в главном потоке.
+     */
+    void onTopicDecoded();
+
+private:
+    /// @brief Ключ кэша: индекс темы и хеш ее HTML.
+    using Key = QPair<int, uint>;
+
+    /// @brief Максимальная длина очереди предварительной загрузки.
+    static constexpr int MaxQueuedTopics = 8;
+
+    static Key makeKey(int topicIndex, const Topic& topic);
+
+    /**
+     * @brief Разбирает начальные разделы темы и выполняет их верстку.
+     */
+    QSharedPointer<TopicDocument> build(const Topic& topic) const;
+
+    /**
+     * @brief Строит документ темы и кладет его в кэш, если его там еще нет.
+     */
+    void insertPrefetched(int topicIndex, const Topic& topic);
+
+    CourseAssetCache* m_assets;                          ///< Ресурсы курса
+    QCache<Key, QSharedPointer<TopicDocument>> m_cache;  ///< Документы по ключу (LRU)
+    QList<QPair<int, SharedCoursePtr>> m_queue;          ///< Темы, ожидающие построения
+    QTimer m_prefetchTimer;                              ///< Запуск построения в простое
+    QFutureWatcher<TopicPtr> m_decodeWatcher;            ///< Декодирование темы в пуле потоков
+    int m_decodingIndex = -1;                            ///< Индекс декодируемой темы
+    int m_generation = 0;                                ///< Увеличивается при clear()
+    int m_decodingGeneration = 0;                        ///< Поколение декодируемой темы
+    QFont m_font;                                        ///< Шрифт документов
+    qreal m_textWidth = 0;                               ///< Ширина верстки
+};
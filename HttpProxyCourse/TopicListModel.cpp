@@ -0,0 +1,175 @@
+#include "TopicListModel.h"
+#include <algorithm>
+
+TopicListModel::TopicListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void TopicListModel::setCourse(const SharedCoursePtr& course) {
+    if (course == m_course) {
+        return;
+    }
+
+    beginResetModel();
+    m_course = course;
+    if (!m_filter.isEmpty()) {
+        QVector<int> all(courseTopicCount());
+        for (int i = 0; i < all.size(); ++i) {
+            all[i] = i;
+        }
+        m_rows = filterTopics(all);
+    }
+    endResetModel();
+}
+
+void TopicListModel::insertTopic(const SharedCoursePtr& course, int topicIndex) {
+    if (m_filter.isEmpty()) {
+        beginInsertRows(QModelIndex(), topicIndex, topicIndex);
+        m_course = course;
+        endInsertRows();
+        return;
+    }
+
+    // Видимые строки не меняются, меняются только индексы следующих за темой
+    m_course = course;
+    shiftRows(topicIndex, 1);
+    if (matchesFilter(topicIndex)) {
+        const int row = static_cast<int>(std::lower_bound(m_rows.cbegin(), m_rows.cend(), topicIndex)
+                                         - m_rows.cbegin());
+        beginInsertRows(QModelIndex(), row, row);
+        m_rows.insert(row, topicIndex);
+        endInsertRows();
+    }
+}
+
+void TopicListModel::removeTopic(const SharedCoursePtr& course, int topicIndex) {
+    const int row = rowForTopic(topicIndex);
+    if (row >= 0) {
+        beginRemoveRows(QModelIndex(), row, row);
+        if (!m_filter.isEmpty()) {
+            m_rows.remove(row);
+        }
+        m_course = course;
+        shiftRows(topicIndex + 1, -1);
+        endRemoveRows();
+    } else {
+        m_course = course;
+        shiftRows(topicIndex + 1, -1);
+    }
+}
+
+void TopicListModel::updateTopic(const SharedCoursePtr& course, int topicIndex) {
+    const int row = rowForTopic(topicIndex);
+    m_course = course;
+
+    const bool visible = m_filter.isEmpty() || matchesFilter(topicIndex);
+    if (row >= 0 && visible) {
+        emit dataChanged(index(row), index(row));
+    } else if (row >= 0) {
+        // Новое название больше не проходит фильтр
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rows.remove(row);
+        endRemoveRows();
+    } else if (visible) {
+        const int newRow = static_cast<int>(std::lower_bound(m_rows.cbegin(), m_rows.cend(), topicIndex)
+                                            - m_rows.cbegin());
+        beginInsertRows(QModelIndex(), newRow, newRow);
+        m_rows.insert(newRow, topicIndex);
+        endInsertRows();
+    }
+}
+
+void TopicListModel::setFilterText(const QString& text) {
+    const QString filter = text.trimmed();
+    if (filter == m_filter) {
+        return;
+    }
+
+    // Продолжение прежнего текста может только сузить результат
+    const bool narrowing = !m_filter.isEmpty() && filter.startsWith(m_filter, Qt::CaseInsensitive);
+
+    beginResetModel();
+    QVector<int> candidates;
+    if (narrowing) {
+        candidates.swap(m_rows);
+    } else if (!filter.isEmpty()) {
+        candidates.resize(courseTopicCount());
+        for (int i = 0; i < candidates.size(); ++i) {
+            candidates[i] = i;
+        }
+    }
+    m_filter = filter;
+    m_rows = m_filter.isEmpty() ? QVector<int>() : filterTopics(candidates);
+    endResetModel();
+}
+
+int TopicListModel::topicIndex(int row) const {
+    if (row < 0 || row >= rowCount()) {
+        return -1;
+    }
+    return m_filter.isEmpty() ? row : m_rows[row];
+}
+
+int TopicListModel::rowForTopic(int topicIndex) const {
+    if (topicIndex < 0 || topicIndex >= courseTopicCount()) {
+        return -1;
+    }
+    if (m_filter.isEmpty()) {
+        return topicIndex;
+    }
+
+    // m_rows упорядочен по возрастанию индексов тем
+    const auto it = std::lower_bound(m_rows.cbegin(), m_rows.cend(), topicIndex);
+    return it != m_rows.cend() && *it == topicIndex ? static_cast<int>(it - m_rows.cbegin()) : -1;
+}
+
+int TopicListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_filter.isEmpty() ? courseTopicCount() : m_rows.size();
+}
+
+QVariant TopicListModel::data(const QModelIndex& index, int role) const {
+    const int topic = topicIndex(index.row());
+    if (!index.isValid() || topic < 0) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return m_course->topicTitle(topic);
+    case TopicIndexRole:
+        return topic;
+    default:
+        return QVariant();
+    }
+}
+
+bool TopicListModel::matchesFilter(int topicIndex) const {
+    return m_course->topicTitle(topicIndex).contains(m_filter, Qt::CaseInsensitive);
+}
+
+void TopicListModel::shiftRows(int topicIndex, int delta) {
+    for (int& topic : m_rows) {
+        if (topic >= topicIndex) {
+            topic += delta;
+        }
+    }
+}
+
+QVector<int> TopicListModel::filterTopics(const QVector<int>& candidates) const {
+    QVector<int> rows;
+    for (int topic : candidates) {
+        if (matchesFilter(topic)) {
+            rows.append(topic);
+        }
+    }
+    return rows;
+}
+
+int TopicListModel::courseTopicCount() const {
+    return m_course ? m_course->topicCount() : 0;
+}
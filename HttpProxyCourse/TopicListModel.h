@@ -0,0 +1,117 @@
+#pragma once
+
+#include "SharedCourse.h"
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Модель списка тем поверх общего снимка курса.
+ *
+ * Строки не хранятся: названия читаются из SharedCourse по запросу
+ * представления, поэтому смена курса — сброс модели за постоянное время,
+ * а представление создает строки только для видимой области.
+ *
+ * Правка одной темы отражается insertTopic(), removeTopic() и updateTopic():
+ * представление получает сигналы для одной строки вместо сброса модели.
+ *
+ * Фильтр по подстроке названия (без учета регистра) сужается
+ * инкрементально: если новый текст продолжает прежний, просматриваются
+ * только строки, прошедшие прежний фильтр.
+ */
+class TopicListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /// @brief Роль с индексом темы в курсе (строка модели при фильтре с ним не совпадает).
+    static constexpr int TopicIndexRole = Qt::UserRole + 1;
+
+    /**
+     * @brief Конструктор модели.
+     * @param parent Родительский объект.
+     */
+    explicit TopicListModel(QObject* parent = nullptr);
+
+    /**
+     * @brief Задает снимок курса; тот же снимок повторно не обрабатывается.
+     * @param course Снимок курса.
+     */
+    void setCourse(const SharedCoursePtr& course);
+
+    /**
+     * @brief Переходит на снимок, в котором добавлена тема.
+     * @param course Новый снимок курса.
+     * @param topicIndex Индекс добавленной темы.
+     */
+    void insertTopic(const SharedCoursePtr& course, int topicIndex);
+
+    /**
+     * @brief Переходит на снимок, из которого удалена тема.
+     * @param course Новый снимок курса.
+     * @param topicIndex Индекс удаленной темы.
+     */
+    void removeTopic(const SharedCoursePtr& course, int topicIndex);
+
+    /**
+     * @brief Переходит на снимок, в котором изменена тема.
+     * @param course Новый снимок курса.
+     * @param topicIndex Индекс измененной темы.
+     */
+    void updateTopic(const SharedCoursePtr& course, int topicIndex);
+
+    /**
+     * @brief Возвращает текущий снимок курса.
+     */
+    const SharedCoursePtr& course() const { return m_course; }
+
+    /**
+     * @brief Задает текст фильтра по названию темы.
+     * @param text Подстрока названия; пустая строка отключает фильтр.
+     */
+    void setFilterText(const QString& text);
+
+    /**
+     * @brief Возвращает текущий текст фильтра.
+     */
+    const QString& filterText() const { return m_filter; }
+
+    /**
+     * @brief Возвращает индекс темы в курсе для строки модели.
+     * @return -1, если строка вне диапазона.
+     */
+    int topicIndex(int row) const;
+
+    /**
+     * @brief Возвращает строку модели для темы курса.
+     * @return -1, если тема скрыта фильтром или отсутствует.
+     */
+    int rowForTopic(int topicIndex) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    /**
+     * @brief Проверяет, проходит ли тема текущего снимка фильтр.
+     */
+    bool matchesFilter(int topicIndex) const;
+
+    /**
+     * @brief Сдвигает индексы тем в m_rows, начиная с topicIndex, на delta.
+     */
+    void shiftRows(int topicIndex, int delta);
+
+    /**
+     * @brief Отбирает темы из candidates, название которых содержит текущий фильтр.
+     */
+    QVector<int> filterTopics(const QVector<int>& candidates) const;
+
+    /**
+     * @brief Количество тем курса (0, если курс не задан).
+     */
+    int courseTopicCount() const;
+
+    SharedCoursePtr m_course;  ///< Снимок курса
+    QString m_filter;          ///< Текст фильтра
+    QVector<int> m_rows;       ///< Индексы тем, прошедших фильтр (при пустом фильтре не используется)
+};
@@ -1,4 +1,5 @@
 #include "TopicSelectionWidget.h"
+#include <QItemSelectionModel>
 #include <QMessageBox>
 
 TopicSelectionWidget::TopicSelectionWidget(QWidget *parent) : QWidget(parent) {
@@ -8,14 +9,36 @@ TopicSelectionWidget::TopicSelectionWidget(QWidget *parent) : QWidget(parent) {
     font.setPointSize(12);
     m_titleLabel->setFont(font);
 
-    m_topicsList = new QListWidget(this);
+    m_filterEdit = new QLineEdit(this);
+    m_filterEdit->setPlaceholderText("Поиск по курсу...");
+    m_filterEdit->setClearButtonEnabled(true);
+
+    // Строки одинаковой высоты: представлению не нужно измерять каждую тему
+    m_model = new TopicListModel(this);
+    m_topicsList = new QListView(this);
+    m_topicsList->setModel(m_model);
+    m_topicsList->setUniformItemSizes(true);
+    m_topicsList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_topicsList->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    // Результаты поиска по тексту тем видны, только пока есть что показать
+    m_search = new CourseSearch(this);
+    m_searchLabel = new QLabel("Найдено в тексте тем:", this);
+    m_searchResults = new QListWidget(this);
+    m_searchResults->setUniformItemSizes(true);
+    m_searchLabel->hide();
+    m_searchResults->hide();
+
     m_selectButton = new QPushButton("Выбрать тему", this);
     m_profileButton = new QPushButton("👤 Мой профиль", this);
     m_logoutButton = new QPushButton("Выход в меню", this);
 
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->addWidget(m_titleLabel);
+    layout->addWidget(m_filterEdit);
     layout->addWidget(m_topicsList);
+    layout->addWidget(m_searchLabel);
+    layout->addWidget(m_searchResults);
 
     QHBoxLayout *btnLayout = new QHBoxLayout();
     btnLayout->addWidget(m_logoutButton);
@@ -27,38 +50,134 @@ TopicSelectionWidget::TopicSelectionWidget(QWidget *parent) : QWidget(parent) {
     connect(m_logoutButton, &QPushButton::clicked, this, &TopicSelectionWidget::logoutRequested);
     connect(m_profileButton, &QPushButton::clicked, this, &TopicSelectionWidget::onProfileClicked);
     connect(m_selectButton, &QPushButton::clicked, this, &TopicSelectionWidget::onSelectClicked);
-    connect(m_topicsList, &QListWidget::itemDoubleClicked, this, &TopicSelectionWidget::onListDoubleClicked);
+    connect(m_topicsList, &QListView::doubleClicked, this, &TopicSelectionWidget::onListDoubleClicked);
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &TopicSelectionWidget::onFilterChanged);
+    connect(m_filterEdit, &QLineEdit::returnPressed, this, &TopicSelectionWidget::onSelectClicked);
+    connect(m_search, &CourseSearch::indexReady, this, &TopicSelectionWidget::updateSearchResults);
+    connect(m_searchResults, &QListWidget::itemActivated, this, &TopicSelectionWidget::onSearchResultActivated);
+    connect(m_topicsList->selectionModel(), &QItemSelectionModel::currentChanged, this,
+            [this](const QModelIndex& current) {
+                const int topicIndex = m_model->topicIndex(current.row());
+                if (topicIndex >= 0) {
+                    emit topicHighlighted(topicIndex);
+                }
+            });
 }
 
-void TopicSelectionWidget::setTopics(const QList<Topic>& topics) {
-    m_topicsList->clear();
-    for (const auto& topic : topics) {
-        m_topicsList->addItem(topic.title);
-    }
+void TopicSelectionWidget::setCourse(const SharedCoursePtr& course) {
+    const int current = currentTopicIndex();
+    m_model->setCourse(course);
+    m_search->setCourse(course);
+    selectTopic(current);
+    updateSearchResults();
+}
+
+void TopicSelectionWidget::insertTopic(const SharedCoursePtr& course, int topicIndex) {
+    m_model->insertTopic(course, topicIndex);
+    m_search->setCourse(course);
+    updateSearchResults();
+}
+
+void TopicSelectionWidget::removeTopic(const SharedCoursePtr& course, int topicIndex) {
+    m_model->removeTopic(course, topicIndex);
+    m_search->setCourse(course);
+    updateSearchResults();
+}
+
+void TopicSelectionWidget::updateTopic(const SharedCoursePtr& course, int topicIndex) {
+    m_model->updateTopic(course, topicIndex);
+    m_search->setCourse(course);
+    updateSearchResults();
 }
 
 void TopicSelectionWidget::setLastStudiedTopic(int topicId) {
-    // Выделяем последнюю изученную тему в списке
-    if (topicId >= 0 && topicId < m_topicsList->count()) {
-        m_topicsList->setCurrentRow(topicId);
-        m_topicsList->scrollToItem(m_topicsList->item(topicId));
+    // Выделяем последнюю изученную тему в списке; скрытая фильтром тема делает его недействительным
+    if (m_model->rowForTopic(topicId) < 0 && !m_filterEdit->text().isEmpty()) {
+        m_filterEdit->clear();
     }
+    selectTopic(topicId);
 }
 
 void TopicSelectionWidget::onSelectClicked() {
-    int currentRow = m_topicsList->currentRow();
-    if (currentRow >= 0) {
-        emit topicSelected(currentRow);
+    const int topicIndex = currentTopicIndex();
+    if (topicIndex >= 0) {
+        emit topicSelected(topicIndex);
     } else {
         QMessageBox::warning(this, "Внимание", "Пожалуйста, выберите тему из списка.");
     }
 }
 
-void TopicSelectionWidget::onListDoubleClicked(QListWidgetItem *item) {
-    Q_UNUSED(item);
+void TopicSelectionWidget::onListDoubleClicked(const QModelIndex& index) {
+    Q_UNUSED(index);
     onSelectClicked();
 }
 
+void TopicSelectionWidget::onFilterChanged(const QString& text) {
+    const int current = currentTopicIndex();
+    m_model->setFilterText(text);
+
+    // Текущая тема остается выделенной, если прошла фильтр; иначе — первая найденная
+    if (m_model->rowForTopic(current) >= 0) {
+        selectTopic(current);
+    } else if (m_model->rowCount() > 0) {
+        selectTopic(m_model->topicIndex(0));
+    }
+    updateSearchResults();
+}
+
+void TopicSelectionWidget::updateSearchResults() {
+    // Короткий запрос совпадает почти со всем курсом
+    const QString query = m_filterEdit->text().trimmed();
+    const QVector<SearchHit> hits = query.size() >= MinSearchLength ? m_search->search(query) : QVector<SearchHit>();
+
+    // Результаты привязаны к снимку, для которого их отобрал CourseSearch
+    m_searchResultsCourse = m_search->course();
+    const SharedCoursePtr& course = m_searchResultsCourse;
+
+    m_searchResults->clear();
+    for (const SearchHit& hit : hits) {
+        QString text = course->topicTitle(hit.topicIndex);
+        if (!hit.sectionTitle.isEmpty()) {
+            text += QString(" — %1").arg(hit.sectionTitle);
+        }
+        QListWidgetItem* item = new QListWidgetItem(text, m_searchResults);
+        item->setToolTip(text);
+        item->setData(TopicListModel::TopicIndexRole, hit.topicIndex);
+        item->setData(SectionRole, hit.section);
+    }
+
+    const bool visible = m_searchResults->count() > 0;
+    m_searchLabel->setVisible(visible);
+    m_searchResults->setVisible(visible);
+}
+
+void TopicSelectionWidget::onSearchResultActivated(QListWidgetItem* item) {
+    if (!item) {
+        return;
+    }
+    // Курс изменился после отбора результатов: индексы тем могли сдвинуться
+    if (m_searchResultsCourse != m_model->course()) {
+        updateSearchResults();
+        return;
+    }
+    emit searchResultSelected(item->data(TopicListModel::TopicIndexRole).toInt(), item->data(SectionRole).toInt());
+}
+
 void TopicSelectionWidget::onProfileClicked() {
     emit profileRequested();
 }
+
+int TopicSelectionWidget::currentTopicIndex() const {
+    const QModelIndex current = m_topicsList->currentIndex();
+    return current.isValid() ? m_model->topicIndex(current.row()) : -1;
+}
+
+void TopicSelectionWidget::selectTopic(int topicIndex) {
+    const int row = m_model->rowForTopic(topicIndex);
+    if (row < 0) {
+        return;
+    }
+    const QModelIndex index = m_model->index(row);
+    m_topicsList->setCurrentIndex(index);
+    m_topicsList->scrollTo(index);
+}
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "CourseSearch.h"
 #include "DomainTypes.h"
+#include "SharedCourse.h"
+#include "TopicListModel.h"
 #include <QWidget>
 #include <QLabel>
+#include <QLineEdit>
+#include <QListView>
 #include <QListWidget>
 #include <QPushButton>
 #include <QVBoxLayout>
@@ -11,6 +16,13 @@
  * @brief Виджет выбора темы для изучения.
  * 
  * Отображает список доступных тем курса и позволяет студенту выбрать тему для изучения.
+ * Список построен на TopicListModel поверх общего снимка курса: строки
+ * одинаковой высоты создаются только для видимой области, а поле поиска
+ * сужает список по мере ввода.
+ *
+ * То же поле ищет по теории и вопросам тем (CourseSearch): найденные темы
+ * показываются под списком с заголовком лучшего раздела, выбор результата
+ * открывает тему на этом разделе.
  */
 class TopicSelectionWidget : public QWidget {
     Q_OBJECT
@@ -23,10 +35,32 @@ public:
     explicit TopicSelectionWidget(QWidget *parent = nullptr);
 
     /**
-     * @brief Устанавливает список тем для отображения.
-     * @param topics Список тем курса.
+     * @brief Устанавливает курс, темы которого отображаются.
+     * Повторная установка того же снимка ничего не делает.
+     * @param course Снимок курса.
      */
-    void setTopics(const QList<Topic>& topics);
+    void setCourse(const SharedCoursePtr& course);
+
+    /**
+     * @brief Добавляет в список тему нового снимка курса.
+     * @param course Снимок курса с добавленной темой.
+     * @param topicIndex Индекс добавленной темы.
+     */
+    void insertTopic(const SharedCoursePtr& course, int topicIndex);
+
+    /**
+     * @brief Удаляет из списка тему, отсутствующую в новом снимке курса.
+     * @param course Снимок курса без темы.
+     * @param topicIndex Индекс удаленной темы.
+     */
+    void removeTopic(const SharedCoursePtr& course, int topicIndex);
+
+    /**
+     * @brief Обновляет строку измененной темы.
+     * @param course Снимок курса с измененной темой.
+     * @param topicIndex Индекс темы.
+     */
+    void updateTopic(const SharedCoursePtr& course, int topicIndex);
 
     /**
      * @brief Устанавливает последнюю изученную тему.
@@ -37,10 +71,24 @@ public:
 signals:
     /**
      * @brief Сигнал выбора темы.
-     * @param index Индекс выбранной темы.
+     * @param index Индекс выбранной темы в курсе.
      */
     void topicSelected(int index);
 
+    /**
+     * @brief Сигнал перемещения выделения по списку тем.
+     * Используется для заблаговременной подготовки теории соседних тем.
+     * @param index Индекс выделенной темы в курсе.
+     */
+    void topicHighlighted(int index);
+
+    /**
+     * @brief Сигнал выбора результата полнотекстового поиска.
+     * @param index Индекс темы в курсе.
+     * @param section Раздел темы (см. SearchHit::section).
+     */
+    void searchResultSelected(int index, int section);
+
     /**
      * @brief Сигнал запроса выхода из системы.
      */
@@ -59,9 +107,26 @@ private slots:
 
     /**
      * @brief Обработчик двойного клика по элементу списка.
-     * @param item Элемент списка.
+     * @param index Индекс элемента в модели.
+     */
+    void onListDoubleClicked(const QModelIndex& index);
+
+    /**
+     * @brief Обработчик изменения текста поиска.
+     * @param text Текст фильтра.
+     */
+    void onFilterChanged(const QString& text);
+
+    /**
+     * @brief Выполняет полнотекстовый поиск по тексту поля поиска.
+     */
+    void updateSearchResults();
+
+    /**
+     * @brief Обработчик выбора результата поиска.
+     * @param item Выбранный результат.
      */
-    void onListDoubleClicked(QListWidgetItem *item);
+    void onSearchResultActivated(QListWidgetItem* item);
 
     /**
      * @brief Обработчик нажатия кнопки профиля.
@@ -69,8 +134,30 @@ private slots:
     void onProfileClicked();
 
 private:
+    /// @brief Наименьшая длина запроса для поиска по тексту тем.
+    static constexpr int MinSearchLength = 3;
+
+    /// @brief Роль с разделом темы у результата поиска.
+    static constexpr int SectionRole = TopicListModel::TopicIndexRole + 1;
+
+    /**
+     * @brief Возвращает индекс текущей темы в курсе или -1.
+     */
+    int currentTopicIndex() const;
+
+    /**
+     * @brief Делает текущей строку указанной темы.
+     */
+    void selectTopic(int topicIndex);
+
     QLabel *m_titleLabel;
-    QListWidget *m_topicsList;
+    QLineEdit *m_filterEdit;
+    QListView *m_topicsList;
+    TopicListModel *m_model;
+    QLabel *m_searchLabel;
+    QListWidget *m_searchResults;
+    CourseSearch *m_search;
+    SharedCoursePtr m_searchResultsCourse;  ///< Снимок, к которому относятся показанные результаты поиска
     QPushButton *m_selectButton;
     QPushButton *m_profileButton;
     QPushButton *m_logoutButton;
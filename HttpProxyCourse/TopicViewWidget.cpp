@@ -3,8 +3,12 @@
 #include "SessionManager.h"
 #include <QCloseEvent>
 #include <QDebug>
+#include <QAbstractTextDocumentLayout>
+#include <QScrollBar>
+#include <QTextBlock>
 
-TopicViewWidget::TopicViewWidget(QWidget *parent) : QWidget(parent), currentTopicIndex(-1) {
+TopicViewWidget::TopicViewWidget(QWidget *parent)
+    : QWidget(parent), currentTopicIndex(-1), m_documentCache(&m_assetCache) {
     auto layout = new QVBoxLayout(this);
 
     textBrowser = new QTextBrowser(this);
@@ -20,14 +24,84 @@ TopicViewWidget::TopicViewWidget(QWidget *parent) : QWidget(parent), currentTopi
 
     connect(btnStartTest, &QPushButton::clicked, this, &TopicViewWidget::startTestRequested);
     connect(btnBack, &QPushButton::clicked, this, &TopicViewWidget::onBackClicked);
+
+    m_sectionTimer = new QTimer(this);
+    m_sectionTimer->setInterval(0);
+    connect(m_sectionTimer, &QTimer::timeout, this, &TopicViewWidget::appendPendingSection);
+    connect(textBrowser->verticalScrollBar(), &QScrollBar::valueChanged, this, &TopicViewWidget::onScrolled);
+}
+
+TopicViewWidget::~TopicViewWidget() {
+    // Документ принадлежит кэшу и удаляется раньше дочернего QTextBrowser
+    textBrowser->setDocument(nullptr);
 }
 
 void TopicViewWidget::showTopic(const Topic& topic, int topicIndex) {
-    textBrowser->setHtml(topic.htmlContent);
+    m_documentCache.setLayoutParameters(textBrowser->font(), textBrowser->viewport()->width());
+
+    // Предыдущий документ освобождается только после переключения браузера
+    QSharedPointer<TopicDocument> document = m_documentCache.document(topicIndex, topic);
+    textBrowser->setDocument(document.data());
+    m_currentDocument = document;
     currentTopicIndex = topicIndex;
+
+    // Начало темы уже сверстано; остальные разделы дописываются после отрисовки
+    if (m_currentDocument->hasPendingSections()) {
+        m_sectionTimer->start();
+    } else {
+        m_sectionTimer->stop();
+    }
     qDebug() << "Showing topic" << topicIndex << ":" << topic.title;
 }
 
+void TopicViewWidget::showSection(int section) {
+    if (!m_currentDocument || section <= 0) {
+        return;
+    }
+
+    // Заголовок может оказаться в еще не разобранном разделе
+    for (;;) {
+        int headings = 0;
+        for (QTextBlock block = m_currentDocument->begin(); block.isValid(); block = block.next()) {
+            const int level = block.blockFormat().headingLevel();
+            if (level >= 1 && level <= 3 && ++headings == section) {
+                scrollToPosition(block.position());
+                return;
+            }
+        }
+        if (!m_currentDocument->appendNextSection()) {
+            qWarning() << "Section" << section << "not found in topic" << currentTopicIndex;
+            return;
+        }
+    }
+}
+
+void TopicViewWidget::setCourse(const SharedCoursePtr& course) {
+    // Документы другого курса могли сохранить у себя его изображения
+    if (m_assetCache.setCourse(course)) {
+        m_documentCache.clear();
+    }
+}
+
+void TopicViewWidget::prefetchTopic(const SharedCoursePtr& course, int topicIndex) {
+    m_documentCache.prefetch(topicIndex, course);
+}
+
+void TopicViewWidget::appendPendingSection() {
+    if (!m_currentDocument || !m_currentDocument->appendNextSection()
+        || !m_currentDocument->hasPendingSections()) {
+        m_sectionTimer->stop();
+    }
+}
+
+void TopicViewWidget::onScrolled(int value) {
+    const QScrollBar* scrollBar = textBrowser->verticalScrollBar();
+    if (m_currentDocument && m_currentDocument->hasPendingSections()
+        && value >= scrollBar->maximum() - scrollBar->pageStep()) {
+        m_currentDocument->appendNextSection();
+    }
+}
+
 void TopicViewWidget::closeEvent(QCloseEvent* event) {
     updateUserProgress();
     QWidget::closeEvent(event);
@@ -38,6 +112,22 @@ void TopicViewWidget::onBackClicked() {
     emit backRequested();
 }
 
+void TopicViewWidget::scrollToPosition(int position) {
+    QTextCursor cursor(m_currentDocument.data());
+    cursor.setPosition(position);
+    textBrowser->setTextCursor(cursor);
+
+    const TopicDocument* document = m_currentDocument.data();
+    QTimer::singleShot(0, this, [this, document, position]() {
+        if (m_currentDocument.data() != document) {
+            return;  // За это время открыта другая тема
+        }
+        const QTextBlock block = document->findBlock(position);
+        const QRectF rect = document->documentLayout()->blockBoundingRect(block);
+        textBrowser->verticalScrollBar()->setValue(qRound(rect.top()));
+    });
+}
+
 void TopicViewWidget::updateUserProgress() {
     if (currentTopicIndex < 0) {
         return; // Нет активной темы
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "CourseAssetCache.h"
 #include "DomainTypes.h"
+#include "TopicDocumentCache.h"
 #include <QWidget>
 #include <QTextBrowser>
+#include <QTimer>
 #include <QPushButton>
 #include <QVBoxLayout>
 
@@ -22,6 +25,11 @@ public:
      */
     explicit TopicViewWidget(QWidget *parent = nullptr);
 
+    /**
+     * @brief Деструктор. Отключает QTextBrowser от документа из кэша.
+     */
+    ~TopicViewWidget() override;
+
     /**
      * @brief Отображает содержимое указанной темы.
      * @param topic Тема для отображения.
@@ -29,6 +37,29 @@ public:
      */
     void showTopic(const Topic& topic, int topicIndex);
 
+    /**
+     * @brief Прокручивает показанную тему к разделу (результат поиска).
+     * Недостающие разделы документа дописываются до нужного заголовка.
+     * @param section Номер заголовка h1–h3 (с 1); 0 и -1 оставляют начало темы.
+     */
+    void showSection(int section);
+
+    /**
+     * @brief Задает курс, из контейнера которого загружаются изображения теории.
+     * @param course Снимок курса.
+     */
+    void setCourse(const SharedCoursePtr& course);
+
+    /**
+     * @brief Заранее готовит документ темы, чтобы ее открытие было мгновенным.
+     *
+     * Тело темы декодируется в фоне и не загружается в снимок курса.
+     *
+     * @param course Снимок курса.
+     * @param topicIndex Индекс темы.
+     */
+    void prefetchTopic(const SharedCoursePtr& course, int topicIndex);
+
 signals:
     /**
      * @brief Сигнал запроса начала тестирования.
@@ -60,14 +91,36 @@ private slots:
      */
     void onBackClicked();
 
+    /**
+     * @brief Дописывает в документ очередной раздел темы.
+     * Вызывается в простое, пока у документа есть неразобранные разделы.
+     */
+    void appendPendingSection();
+
+    /**
+     * @brief Обработчик прокрутки: при приближении к концу дописывает раздел сразу.
+     * @param value Положение вертикальной полосы прокрутки.
+     */
+    void onScrolled(int value);
+
 private:
     /**
      * @brief Обновляет прогресс пользователя.
      */
     void updateUserProgress();
 
+    /**
+     * @brief Прокручивает документ так, чтобы блок с позицией position оказался вверху.
+     * Прокрутка откладывается до верстки показанного виджета.
+     */
+    void scrollToPosition(int position);
+
     QTextBrowser* textBrowser;
     QPushButton* btnStartTest;
     QPushButton* btnBack;
     int currentTopicIndex;  ///< Индекс текущей темы
+    QTimer* m_sectionTimer;  ///< Дозагрузка разделов в простое
+    CourseAssetCache m_assetCache;                    ///< Изображения из контейнера курса
+    TopicDocumentCache m_documentCache;               ///< Разобранные документы тем
+    QSharedPointer<TopicDocument> m_currentDocument;  ///< Показанный документ
 };
@@ -1,5 +1,6 @@
 #include "UserDao.h"
 #include "DatabaseManager.h"
+#include "DbExecutor.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -13,8 +14,7 @@ User UserDao::findByLogin(const QString& login) {
         return user;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT id, login, full_name, role FROM users WHERE login = ?");
+    QSqlQuery query = dbManager.preparedQuery("SELECT id, login, full_name, role FROM users WHERE login = ?");
     query.addBindValue(login.trimmed());
     
     if (!query.exec()) {
@@ -39,8 +39,7 @@ bool UserDao::create(const User& user, const QString& passwordHash) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("INSERT INTO users (login, password_hash, full_name, role) VALUES (?, ?, ?, ?)");
+    QSqlQuery query = dbManager.preparedQuery("INSERT INTO users (login, password_hash, full_name, role) VALUES (?, ?, ?, ?)");
     query.addBindValue(user.login.trimmed());
     query.addBindValue(passwordHash);
     query.addBindValue(user.fullName.trimmed());
@@ -61,8 +60,7 @@ bool UserDao::existsByLogin(const QString& login) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT COUNT(*) FROM users WHERE login = ?");
+    QSqlQuery query = dbManager.preparedQuery("SELECT COUNT(*) FROM users WHERE login = ?");
     query.addBindValue(login.trimmed());
     
     if (!query.exec()) {
@@ -82,8 +80,7 @@ QList<User> UserDao::findAll() {
         return users;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("SELECT id, login, full_name, role FROM users ORDER BY id");
+    QSqlQuery query = dbManager.preparedQuery("SELECT id, login, full_name, role FROM users ORDER BY id");
     
     if (!query.exec()) {
         qCritical() << "Failed to fetch all users:" << query.lastError().text();
@@ -109,8 +106,7 @@ bool UserDao::update(const User& user) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("UPDATE users SET login = ?, full_name = ?, role = ? WHERE id = ?");
+    QSqlQuery query = dbManager.preparedQuery("UPDATE users SET login = ?, full_name = ?, role = ? WHERE id = ?");
     query.addBindValue(user.login.trimmed());
     query.addBindValue(user.fullName.trimmed());
     query.addBindValue(user.role);
@@ -131,8 +127,7 @@ bool UserDao::deleteById(int userId) {
         return false;
     }
     
-    QSqlQuery query(dbManager.database());
-    query.prepare("DELETE FROM users WHERE id = ?");
+    QSqlQuery query = dbManager.preparedQuery("DELETE FROM users WHERE id = ?");
     query.addBindValue(userId);
     
     if (!query.exec()) {
@@ -141,4 +136,28 @@ bool UserDao::deleteById(int userId) {
     }
     
     return query.numRowsAffected() > 0;
-}
\ No newline at end of file
+}
+
+QFuture<User> UserDao::findByLoginAsync(const QString& login) {
+    return DbExecutor::run([login]() { return findByLogin(login); });
+}
+
+QFuture<bool> UserDao::createAsync(const User& user, const QString& passwordHash) {
+    return DbExecutor::run([user, passwordHash]() { return create(user, passwordHash); });
+}
+
+QFuture<bool> UserDao::existsByLoginAsync(const QString& login) {
+    return DbExecutor::run([login]() { return existsByLogin(login); });
+}
+
+QFuture<QList<User>> UserDao::findAllAsync() {
+    return DbExecutor::run([]() { return findAll(); });
+}
+
+QFuture<bool> UserDao::updateAsync(const User& user) {
+    return DbExecutor::run([user]() { return update(user); });
+}
+
+QFuture<bool> UserDao::deleteByIdAsync(int userId) {
+    return DbExecutor::run([userId]() { return deleteById(userId); });
+}
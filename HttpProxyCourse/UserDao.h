@@ -2,6 +2,7 @@
 
 #include "DomainTypes.h"
 #include <QString>
+#include <QFuture>
 #include <QList>
 
 /**
@@ -52,4 +53,24 @@ public:
      * @return true, если удаление прошло успешно.
      */
     static bool deleteById(int userId);
+
+    // Асинхронные варианты: запросы к таблице users выполняются в пуле
+    // потоков БД (DbExecutor), результат доставляется через QFuture.
+    /// @brief Асинхронный findByLogin().
+    static QFuture<User> findByLoginAsync(const QString& login);
+
+    /// @brief Асинхронный create().
+    static QFuture<bool> createAsync(const User& user, const QString& passwordHash);
+
+    /// @brief Асинхронный existsByLogin().
+    static QFuture<bool> existsByLoginAsync(const QString& login);
+
+    /// @brief Асинхронный findAll().
+    static QFuture<QList<User>> findAllAsync();
+
+    /// @brief Асинхронный update().
+    static QFuture<bool> updateAsync(const User& user);
+
+    /// @brief Асинхронный deleteById().
+    static QFuture<bool> deleteByIdAsync(int userId);
 };
\ No newline at end of file
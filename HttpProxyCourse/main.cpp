@@ -1,7 +1,8 @@
 #include "mainwindow.h"
-#include "Serializer.h"
 #include "CourseDataConverter.h"
 #include "DatabaseManager.h"
+#include "ProgressWriter.h"
+#include "TestResultQueue.h"
 #include "Logger.h"
 #include <QApplication>
 #include <QFile>
@@ -15,20 +16,14 @@ int main(int argc, char *argv[])
     Logger::setFileLogging(true, "application.log");
     Logger::info("Запуск приложения HTTP Proxy Course", "Main");
     
-    // Проверяем наличие бинарного файла данных курса и создаем его при необходимости
+    // Файл курса не обязателен: при его отсутствии используется встроенный курс,
+    // а course.dat появится при первом сохранении из панели администратора
     const QString courseDataFile = "course.dat";
     
-    if (!QFile::exists(courseDataFile)) {
-        qDebug() << "Course data file not found. Generating binary course data...";
-        try {
-            Serializer::generateCourseData(courseDataFile);
-            qDebug() << "Course data file created successfully!";
-        } catch (const std::exception& e) {
-            qCritical() << "Failed to generate course data:" << e.what();
-            qCritical() << "Application may not work properly without course data.";
-        }
-    } else {
+    if (QFile::exists(courseDataFile)) {
         qDebug() << "Binary course data file found:" << courseDataFile;
+    } else {
+        qDebug() << "Course data file not found. The embedded default course will be used.";
     }
     
     // Инициализация базы данных
@@ -51,6 +46,10 @@ int main(int argc, char *argv[])
     
     int result = a.exec();
     
+    // Накопленные результаты и прогресс записываются, пока пул соединений еще работает
+    TestResultQueue::instance().shutdown();
+    ProgressWriter::instance().shutdown();
+    
     Logger::info("Завершение работы приложения", "Main");
     return result;
 }
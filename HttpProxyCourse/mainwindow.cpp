@@ -1,4 +1,7 @@
 #include "mainwindow.h"
+#include "DbExecutor.h"
+#include "ProgressWriter.h"
+#include "TestResultQueue.h"
 #include <QApplication>
 
 // Константа для имени файла курса
@@ -15,6 +18,7 @@ MainWindow::MainWindow(QWidget *parent)
     setupMenu();
 
     m_stackedWidget = new QStackedWidget(this);
+    m_courseModel = new CourseModel(this);
 
     m_loginWidget = new LoginWidget(this);
     m_topicWidget = new TopicSelectionWidget(this);
@@ -42,6 +46,10 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::handleLogout);
     connect(m_topicWidget, &TopicSelectionWidget::topicSelected,
             this, &MainWindow::onTopicSelected);
+    connect(m_topicWidget, &TopicSelectionWidget::topicHighlighted,
+            this, &MainWindow::onTopicHighlighted);
+    connect(m_topicWidget, &TopicSelectionWidget::searchResultSelected,
+            this, &MainWindow::onSearchResultSelected);
     connect(m_topicWidget, &TopicSelectionWidget::profileRequested,
             this, &MainWindow::onShowProfileRequested);
 
@@ -55,6 +63,7 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_testWidget, &TestWidget::testFinished,
             this, &MainWindow::onTestFinished);
 
+    connectCourseModel();
     loadCourseData();
 }
 
@@ -83,6 +92,7 @@ void MainWindow::showAboutDialog() {
 void MainWindow::loadCourseData() {
     try {
         m_sessionManager.loadCourse(COURSE_DATA_FILE);
+        m_courseModel->setCourse(m_sessionManager.getCourse());
     } catch (const std::exception& e) {
         qWarning() << "Could not load course data:" << e.what();
         QMessageBox::warning(this, "Ошибка загрузки", 
@@ -105,18 +115,21 @@ void MainWindow::handleUserAuthenticated(const User& user) {
     
     if (user.isAdmin()) {
         // Администратор - переход к админ-панели
-        if (!m_adminWidget) {
-            m_adminWidget = new AdminWidget(&m_sessionManager.getMutableCourse(), this);
-            connect(m_adminWidget, &AdminWidget::backRequested,
-                    this, &MainWindow::onAdminBackRequested);
-            m_stackedWidget->addWidget(m_adminWidget);
-        }
+        ensureAdminWidget();
         m_adminWidget->setCurrentUser(user); // Установка пользователя для проверки прав
         m_stackedWidget->setCurrentWidget(m_adminWidget);
     } else {
         // Студент - переход к выбору тем
-        m_topicWidget->setTopics(m_sessionManager.getCourse().topics);
+        m_topicWidget->setCourse(m_sessionManager.getCourse());
         m_stackedWidget->setCurrentWidget(m_topicWidget);
+
+        // Прогресс подгружается в фоне; ответ для сменившегося пользователя отбрасывается
+        const int userId = user.id;
+        DbExecutor::then(this, m_sessionManager.loadProgressAsync(), [this, userId](int lastTopicId) {
+            if (m_sessionManager.getCurrentUser().id == userId && m_sessionManager.applyProgress(lastTopicId)) {
+                m_topicWidget->setLastStudiedTopic(lastTopicId);
+            }
+        });
     }
 }
 
@@ -130,31 +143,89 @@ void MainWindow::handleStudentStart() {
     User guestUser(-1, "guest", "Гость", "student");
     m_sessionManager.setCurrentUser(guestUser);
     
-    m_topicWidget->setTopics(m_sessionManager.getCourse().topics);
+    m_topicWidget->setCourse(m_sessionManager.getCourse());
     m_stackedWidget->setCurrentWidget(m_topicWidget);
 }
 
 void MainWindow::handleAdminLogin(const QString& password) {
-    if (AuthService::checkAdminPassword(password)) {
-        if (!m_adminWidget) {
-            // Передаем изменяемую ссылку на курс через SessionManager
-            m_adminWidget = new AdminWidget(&m_sessionManager.getMutableCourse(), this);
-            connect(m_adminWidget, &AdminWidget::backRequested,
-                    this, &MainWindow::onAdminBackRequested);
-            m_stackedWidget->addWidget(m_adminWidget);
+    // Проверка пароля идет в пуле потоков БД, окно остается отзывчивым
+    DbExecutor::then(this, AuthService::checkAdminPasswordAsync(password), [this](bool accepted) {
+        if (!accepted) {
+            QMessageBox::warning(this, "Ошибка доступа", "Неверный пароль администратора.");
+            return;
         }
+        ensureAdminWidget();
         m_stackedWidget->setCurrentWidget(m_adminWidget);
-    } else {
-        QMessageBox::warning(this, "Ошибка доступа", "Неверный пароль администратора.");
+    });
+}
+
+void MainWindow::ensureAdminWidget() {
+    if (m_adminWidget) {
+        return;
     }
+
+    // Панель работает с общим снимком курса и публикует новый после правки;
+    // модель курса рассылает правку по строкам всем представлениям
+    m_adminWidget = new AdminWidget(m_sessionManager.getCourse(), this);
+    connect(m_adminWidget, &AdminWidget::backRequested,
+            this, &MainWindow::onAdminBackRequested);
+    connect(m_adminWidget, &AdminWidget::courseChanged,
+            m_courseModel, &CourseModel::setCourse);
+    m_stackedWidget->addWidget(m_adminWidget);
+}
+
+void MainWindow::connectCourseModel() {
+    connect(m_courseModel, &CourseModel::courseDataChanged, this, [this]() {
+        // Все владельцы переходят на новый снимок курса
+        const SharedCoursePtr course = m_courseModel->getCourse();
+        m_sessionManager.setCourse(course);
+        m_topicWidget->setCourse(course);
+        if (m_adminWidget) {
+            m_adminWidget->setCourse(course);
+        }
+    });
+
+    // Правка одной темы обновляет одну строку в представлениях
+    connect(m_courseModel, &CourseModel::topicInserted, this, [this](int index) {
+        const SharedCoursePtr course = m_courseModel->getCourse();
+        m_sessionManager.setCourse(course);
+        m_topicWidget->insertTopic(course, index);
+        if (m_adminWidget) {
+            m_adminWidget->insertTopic(course, index);
+        }
+    });
+    connect(m_courseModel, &CourseModel::topicRemoved, this, [this](int index) {
+        const SharedCoursePtr course = m_courseModel->getCourse();
+        m_sessionManager.setCourse(course);
+        m_topicWidget->removeTopic(course, index);
+        if (m_adminWidget) {
+            m_adminWidget->removeTopic(course, index);
+        }
+    });
+    connect(m_courseModel, &CourseModel::topicChanged, this,
+            [this](int index, CourseModel::TopicFields fields) {
+                const SharedCoursePtr course = m_courseModel->getCourse();
+                m_sessionManager.setCourse(course);
+                m_topicWidget->updateTopic(course, index);
+                if (m_adminWidget) {
+                    m_adminWidget->updateTopic(course, index, fields.testFlag(CourseModel::ContentField));
+                }
+            });
 }
 
 void MainWindow::handleLogout() {
+    // Результаты и прогресс вышедшего пользователя не ждут таймера
+    TestResultQueue::instance().flush();
+    ProgressWriter::instance().flush();
     m_stackedWidget->setCurrentWidget(m_loginWidget);
 }
 
 void MainWindow::onAdminBackRequested() {
-    loadCourseData();
+    // Правки уже переданы в SessionManager новым снимком; перечитывать файл
+    // нужно, только если курс так и не загрузился
+    if (!m_sessionManager.isCourseLoaded()) {
+        loadCourseData();
+    }
     m_stackedWidget->setCurrentWidget(m_loginWidget);
 }
 
@@ -162,19 +233,49 @@ void MainWindow::onTopicSelected(int index) {
     try {
         m_sessionManager.startTopic(index);
 
-        Topic* topic = m_sessionManager.getCurrentTopic();
+        TopicPtr topic = m_sessionManager.getCurrentTopic();
         if (topic) {
+            m_topicViewWidget->setCourse(m_sessionManager.getCourse());
             m_topicViewWidget->showTopic(*topic, index);
             m_stackedWidget->setCurrentWidget(m_topicViewWidget);
+            prefetchTopicDocuments(index, false);
         }
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Ошибка", QString("Не удалось открыть тему: %1").arg(e.what()));
     }
 }
 
+void MainWindow::onSearchResultSelected(int index, int section) {
+    onTopicSelected(index);
+    if (m_stackedWidget->currentWidget() == m_topicViewWidget) {
+        m_topicViewWidget->showSection(section);
+    }
+}
+
+void MainWindow::onTopicHighlighted(int index) {
+    prefetchTopicDocuments(index, true);
+}
+
+void MainWindow::prefetchTopicDocuments(int index, bool includeCenter) {
+    SharedCoursePtr course = m_sessionManager.getCourse();
+    if (!course) {
+        return;
+    }
+    m_topicViewWidget->setCourse(course);
+
+    // Сначала выделенная тема, затем соседние: их откроют с наибольшей вероятностью
+    const int candidates[] = { index, index + 1, index - 1 };
+    for (int candidate : candidates) {
+        if ((candidate == index && !includeCenter) || candidate < 0 || candidate >= course->topicCount()) {
+            continue;
+        }
+        m_topicViewWidget->prefetchTopic(course, candidate);
+    }
+}
+
 void MainWindow::onStartTestRequested() {
     try {
-        Topic* currentTopic = m_sessionManager.getCurrentTopic();
+        TopicPtr currentTopic = m_sessionManager.getCurrentTopic();
         if (!currentTopic || currentTopic->questions.isEmpty()) {
             QMessageBox::warning(this, "Внимание", "В данной теме отсутствуют вопросы для тестирования.");
             return;
@@ -187,7 +288,7 @@ void MainWindow::onStartTestRequested() {
         }
         
         // Запуск теста с вопросами текущей темы
-        m_testWidget->startTest(currentTopic->questions, currentUser);
+        m_testWidget->startTest(currentTopic, currentUser);
         m_stackedWidget->setCurrentWidget(m_testWidget);
         
     } catch (const std::exception& e) {
@@ -203,7 +304,7 @@ void MainWindow::onAnswerSubmitted(int answerIndex) {
         case SessionManager::SubmitResult::Correct:
             QMessageBox::information(this, "Верно", "Правильный ответ!");
             {
-                Question* nextQ = m_sessionManager.getCurrentQuestion();
+                const Question* nextQ = m_sessionManager.getCurrentQuestion();
                 if (nextQ) {
                     m_testWidget->showQuestion(*nextQ);
                 }
@@ -224,7 +325,7 @@ void MainWindow::onAnswerSubmitted(int answerIndex) {
         case SessionManager::SubmitResult::TopicFinished:
             QMessageBox::information(this, "Успех", "Тема успешно пройдена!");
             m_sessionManager.saveProgress(); // Сохранение прогресса
-            m_topicWidget->setTopics(m_sessionManager.getCourse().topics);
+            m_topicWidget->setCourse(m_sessionManager.getCourse());
             m_stackedWidget->setCurrentWidget(m_topicWidget);
             break;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SessionManager.h"
+#include "CourseModel.h"
 #include "AuthService.h"
 #include "LoginWidget.h"
 #include "TopicSelectionWidget.h"
@@ -71,6 +72,19 @@ private slots:
      */
     void onTopicSelected(int index);
 
+    /**
+     * @brief Обработчик выбора результата поиска: открывает тему на найденном разделе.
+     * @param index Индекс темы.
+     * @param section Раздел темы.
+     */
+    void onSearchResultSelected(int index, int section);
+
+    /**
+     * @brief Обработчик перемещения выделения в списке тем.
+     * @param index Индекс выделенной темы.
+     */
+    void onTopicHighlighted(int index);
+
     /**
      * @brief Обработчик запуска тестирования.
      */
@@ -111,7 +125,26 @@ private:
      */
     void setupMenu();
 
+    /**
+     * @brief Создает панель администратора при первом обращении.
+     */
+    void ensureAdminWidget();
+
+    /**
+     * @brief Подключает сигналы модели курса: замена курса и правка отдельных тем
+     * доходят до сессии, списка тем и панели администратора.
+     */
+    void connectCourseModel();
+
+    /**
+     * @brief Заранее готовит документы темы и ее соседей в списке.
+     * @param index Индекс центральной темы.
+     * @param includeCenter Готовить ли документ самой темы.
+     */
+    void prefetchTopicDocuments(int index, bool includeCenter);
+
     SessionManager m_sessionManager;
+    CourseModel *m_courseModel;
     QStackedWidget *m_stackedWidget;
     LoginWidget *m_loginWidget;
     TopicSelectionWidget *m_topicWidget;
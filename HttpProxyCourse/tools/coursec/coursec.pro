@@ -0,0 +1,20 @@
+# Консольный компилятор курсов: JSON -> course.dat без GUI и дисплейного сервера.
+# Сборка: qmake tools/coursec/coursec.pro && make
+# Замеры: coursec --bench-codec 5000 (кодек тем), coursec --bench-rebuild 5000 (пересборка)
+
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = coursec
+
+include(../../CourseCore.pri)
+
+SOURCES += \
+    main.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,439 @@
+#include "CourseCodec.h"
+#include "CourseDataConverter.h"
+#include "CourseStorage.h"
+#include "DomainTypes.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <functional>
+
+namespace {
+
+/**
+ * @brief Результат компиляции одного файла курса.
+ */
+struct CompileResult {
+    QString jsonFilePath;        ///< Исходный JSON
+    QString binaryFilePath;      ///< Собранный файл курса
+    bool converted = false;      ///< Конвертация завершилась успешно
+    int topicCount = 0;          ///< Количество тем в собранном файле
+    qint64 inputBytes = 0;       ///< Размер исходного JSON
+    qint64 outputBytes = 0;      ///< Размер собранного файла
+    qint64 elapsedMs = 0;        ///< Время конвертации и проверки
+    ValidationReport report;     ///< Результат проверки собранного файла
+};
+
+/**
+ * @brief Декодирует все темы собранного файла и проверяет вопросы.
+ */
+ValidationReport validateBinary(const QString& binaryFilePath, int& topicCount) {
+    ValidationReport report;
+    try {
+        const CourseStorage storage(binaryFilePath);
+        topicCount = storage.topicCount();
+        for (int i = 0; i < topicCount; ++i) {
+            Topic topic;
+            try {
+                storage.readTopicBody(i, topic, &report);
+            } catch (const std::exception& e) {
+                report.failedTopics << QString("%1: %2").arg(storage.titles()[i], e.what());
+            }
+        }
+    } catch (const std::exception& e) {
+        report.failedTopics << QString::fromUtf8(e.what());
+    }
+    return report;
+}
+
+/**
+ * @brief Компилирует один JSON файл и при необходимости проверяет результат.
+ */
+CompileResult compileCourse(const QString& jsonFilePath, const QString& outputDir, bool validate) {
+    CompileResult result;
+    result.jsonFilePath = jsonFilePath;
+
+    const QFileInfo input(jsonFilePath);
+    const QDir targetDir(outputDir.isEmpty() ? input.absolutePath() : outputDir);
+    result.binaryFilePath = targetDir.filePath(input.completeBaseName() + ".dat");
+    result.inputBytes = input.size();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    result.converted = CourseDataConverter::convertJsonToBinary(jsonFilePath, result.binaryFilePath);
+    if (result.converted) {
+        result.outputBytes = QFileInfo(result.binaryFilePath).size();
+        if (validate) {
+            result.report = validateBinary(result.binaryFilePath, result.topicCount);
+        } else {
+            try {
+                result.topicCount = CourseStorage(result.binaryFilePath).topicCount();
+            } catch (const std::exception& e) {
+                result.report.failedTopics << QString::fromUtf8(e.what());
+            }
+        }
+    }
+
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+/**
+ * @brief Переводит объем и время в МБ/с.
+ */
+double megabytesPerSecond(qint64 bytes, qint64 elapsedMs) {
+    return elapsedMs > 0 ? (bytes / (1024.0 * 1024.0)) / (elapsedMs / 1000.0) : 0.0;
+}
+
+/**
+ * @brief Создает синтетическую тему: HTML на русском с разметкой и вопросы
+ *        с повторяющимися вариантами ответов, как в реальных курсах.
+ */
+Topic syntheticTopic(int index) {
+    static const QStringList commonVariants = {
+        QStringLiteral("Да"), QStringLiteral("Нет"), QStringLiteral("Все перечисленное"),
+        QStringLiteral("Ни один из вариантов"), QStringLiteral("HTTP/1.1"), QStringLiteral("CONNECT")
+    };
+
+    Topic topic;
+    topic.title = QStringLiteral("Тема %1. Прокси-серверы HTTP").arg(index + 1);
+    for (int i = 0; i < 40; ++i) {
+        topic.htmlContent += QStringLiteral(
+            "<h2>Раздел %1</h2><p>Прокси-сервер принимает запрос клиента и пересылает его "
+            "<b>целевому серверу</b>; заголовок <code>Via</code> указывает цепочку узлов.</p>"
+            "<ul><li>Кэширование ответов</li><li>Фильтрация запросов</li></ul>").arg(i + 1);
+    }
+    for (int i = 0; i < 10; ++i) {
+        Question question;
+        question.text = QStringLiteral("Вопрос %1 темы %2: какой метод открывает туннель через прокси?")
+                            .arg(i + 1).arg(index + 1);
+        question.variants << commonVariants[i % commonVariants.size()]
+                          << commonVariants[(i + 1) % commonVariants.size()]
+                          << QStringLiteral("Вариант %1").arg(index * 10 + i)
+                          << commonVariants[(i + 2) % commonVariants.size()];
+        question.correctIndex = i % 4;
+        topic.questions.append(question);
+    }
+    return topic;
+}
+
+/**
+ * @brief Способ кодирования тела темы для сравнения.
+ */
+struct BenchCodec {
+    const char* name;
+    std::function<QByteArray(const Topic&, StringPool&)> encode;
+    std::function<void(const QByteArray&, const QStringList&, Topic&)> decode;
+};
+
+/**
+ * @brief Сравнивает QDataStream (формат ранних файлов v2) с CourseCodec на синтетическом курсе.
+ *
+ * Каждый способ кодирует и декодирует все темы несколько раз; выводится лучшее время.
+ * Сжатие zlib не включается: оно одинаково для всех способов.
+ *
+ * @param topicCount Количество тем.
+ * @param out Поток вывода результатов.
+ */
+void benchmarkCodec(int topicCount, QTextStream& out) {
+    constexpr int Rounds = 5;
+
+    QVector<Topic> topics;
+    topics.reserve(topicCount);
+    qint64 htmlChars = 0;
+    for (int i = 0; i < topicCount; ++i) {
+        topics.append(syntheticTopic(i));
+        htmlChars += topics.last().htmlContent.size();
+    }
+
+    const QVector<BenchCodec> codecs = {
+        {"QDataStream Qt_5_15",
+         [](const Topic& topic, StringPool&) {
+             QByteArray data;
+             QDataStream stream(&data, QIODevice::WriteOnly);
+             stream.setVersion(QDataStream::Qt_5_15);
+             stream << topic.htmlContent << topic.questions;
+             return data;
+         },
+         [](const QByteArray& data, const QStringList&, Topic& topic) {
+             QDataStream stream(data);
+             stream.setVersion(QDataStream::Qt_5_15);
+             stream >> topic.htmlContent >> topic.questions;
+         }},
+        {"CourseCodec Compact",
+         [](const Topic& topic, StringPool&) { return CourseCodec::encodeTopicBody(topic); },
+         [](const QByteArray& data, const QStringList&, Topic& topic) {
+             CourseCodec::decodeTopicBody(data, topic);
+         }},
+        {"CourseCodec Pooled",
+         [](const Topic& topic, StringPool& pool) { return CourseCodec::encodePooledTopicBody(topic, pool); },
+         [](const QByteArray& data, const QStringList& pool, Topic& topic) {
+             CourseCodec::decodePooledTopicBody(data, pool, topic);
+         }},
+    };
+
+    out << "Codec benchmark: " << topicCount << " topics, " << htmlChars << " HTML chars, "
+        << topicCount * 10 << " questions, best of " << Rounds << " rounds" << Qt::endl;
+
+    for (const BenchCodec& codec : codecs) {
+        qint64 bestEncodeNs = -1;
+        qint64 bestDecodeNs = -1;
+        qint64 totalBytes = 0;
+        int checkedQuestions = 0;
+
+        for (int round = 0; round < Rounds; ++round) {
+            StringPool pool;
+            QVector<QByteArray> blocks;
+            blocks.reserve(topics.size());
+
+            QElapsedTimer timer;
+            timer.start();
+            for (const Topic& topic : qAsConst(topics)) {
+                blocks.append(codec.encode(topic, pool));
+            }
+            const qint64 encodeNs = timer.nsecsElapsed();
+
+            const QStringList poolStrings = pool.strings();
+            checkedQuestions = 0;
+            timer.restart();
+            for (const QByteArray& block : qAsConst(blocks)) {
+                Topic decoded;
+                codec.decode(block, poolStrings, decoded);
+                checkedQuestions += decoded.questions.size();
+            }
+            const qint64 decodeNs = timer.nsecsElapsed();
+
+            totalBytes = 0;
+            for (const QByteArray& block : qAsConst(blocks)) {
+                totalBytes += block.size();
+            }
+            bestEncodeNs = bestEncodeNs < 0 ? encodeNs : qMin(bestEncodeNs, encodeNs);
+            bestDecodeNs = bestDecodeNs < 0 ? decodeNs : qMin(bestDecodeNs, decodeNs);
+        }
+
+        out << QString("%1  %2 bytes  encode %3 ms  decode %4 ms (%5 MB/s)  %6 questions")
+                   .arg(QLatin1String(codec.name), -20)
+                   .arg(totalBytes, 10)
+                   .arg(bestEncodeNs / 1e6, 8, 'f', 1)
+                   .arg(bestDecodeNs / 1e6, 8, 'f', 1)
+                   .arg(bestDecodeNs > 0 ? (totalBytes / (1024.0 * 1024.0)) / (bestDecodeNs / 1e9) : 0.0, 6, 'f', 1)
+                   .arg(checkedQuestions)
+            << Qt::endl;
+    }
+}
+
+/**
+ * @brief Записывает темы в JSON курса в формате, который читает CourseDataConverter.
+ */
+bool writeCourseJson(const QString& filePath, const QVector<Topic>& topics) {
+    QJsonArray topicsArray;
+    for (const Topic& topic : topics) {
+        QJsonArray questions;
+        for (const Question& question : topic.questions) {
+            questions.append(QJsonObject{
+                {"text", question.text},
+                {"variants", QJsonArray::fromStringList(question.variants)},
+                {"correctIndex", question.correctIndex}
+            });
+        }
+        topicsArray.append(QJsonObject{
+            {"title", topic.title},
+            {"htmlContent", topic.htmlContent},
+            {"questions", questions}
+        });
+    }
+
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly)
+           && file.write(QJsonDocument(QJsonObject{{"topics", topicsArray}}).toJson(QJsonDocument::Compact)) > 0;
+}
+
+/**
+ * @brief Замеряет полную сборку синтетического курса и повторную сборку после правки одной темы.
+ * @param topicCount Количество тем.
+ * @param out Поток вывода результатов.
+ * @return false, если сборка не удалась.
+ */
+bool benchmarkRebuild(int topicCount, QTextStream& out) {
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        return false;
+    }
+    const QString jsonFilePath = dir.filePath("course.json");
+    const QString binaryFilePath = dir.filePath("course.dat");
+
+    QVector<Topic> topics;
+    topics.reserve(topicCount);
+    for (int i = 0; i < topicCount; ++i) {
+        topics.append(syntheticTopic(i));
+    }
+
+    auto build = [&](const char* label) {
+        QElapsedTimer timer;
+        timer.start();
+        const bool converted = CourseDataConverter::convertJsonToBinary(jsonFilePath, binaryFilePath);
+        out << QString("%1  %2 ms").arg(QLatin1String(label), -24).arg(timer.elapsed(), 6) << Qt::endl;
+        return converted;
+    };
+
+    out << "Rebuild benchmark: " << topicCount << " topics, "
+        << QThreadPool::globalInstance()->maxThreadCount() << " threads" << Qt::endl;
+
+    if (!writeCourseJson(jsonFilePath, topics) || !build("full build")) {
+        return false;
+    }
+    if (!build("rebuild, no changes")) {
+        return false;
+    }
+
+    Topic& edited = topics[topicCount / 2];
+    edited.htmlContent += QStringLiteral("<p>Правка администратора.</p>");
+    edited.questions.first().variants.last() = QStringLiteral("Новый вариант ответа");
+    return writeCourseJson(jsonFilePath, topics) && build("rebuild, one topic edited");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("coursec");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compiles JSON course files into binary course.dat containers.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("files", "JSON course files to compile.", "<file.json...>");
+
+    const QCommandLineOption outputOption({"o", "output-dir"},
+                                          "Directory for compiled files (default: next to each input).", "dir");
+    const QCommandLineOption jobsOption({"j", "jobs"},
+                                        "Number of files compiled in parallel (default: CPU count).", "n");
+    const QCommandLineOption noValidateOption("no-validate", "Skip decoding and validating compiled files.");
+    const QCommandLineOption quietOption({"q", "quiet"}, "Print only the summary and errors.");
+    const QCommandLineOption benchCodecOption("bench-codec",
+                                              "Benchmark QDataStream against CourseCodec on a synthetic course "
+                                              "of n topics instead of compiling files.", "n");
+    const QCommandLineOption benchRebuildOption("bench-rebuild",
+                                                "Time a full and an incremental build of a synthetic course "
+                                                "of n topics instead of compiling files.", "n");
+    parser.addOption(outputOption);
+    parser.addOption(jobsOption);
+    parser.addOption(noValidateOption);
+    parser.addOption(quietOption);
+    parser.addOption(benchCodecOption);
+    parser.addOption(benchRebuildOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs < 1) {
+            err << "Invalid number of jobs: " << parser.value(jobsOption) << Qt::endl;
+            return 1;
+        }
+        QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    }
+
+    const bool quiet = parser.isSet(quietOption);
+    if (quiet) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+    }
+
+    auto benchTopicCount = [&parser, &err](const QCommandLineOption& option) {
+        bool ok = false;
+        const int topicCount = parser.value(option).toInt(&ok);
+        if (!ok || topicCount < 1) {
+            err << "Invalid number of topics: " << parser.value(option) << Qt::endl;
+            return 0;
+        }
+        return topicCount;
+    };
+    if (parser.isSet(benchCodecOption)) {
+        const int topicCount = benchTopicCount(benchCodecOption);
+        if (topicCount > 0) {
+            benchmarkCodec(topicCount, out);
+        }
+        return topicCount > 0 ? 0 : 1;
+    }
+    if (parser.isSet(benchRebuildOption)) {
+        const int topicCount = benchTopicCount(benchRebuildOption);
+        return topicCount > 0 && benchmarkRebuild(topicCount, out) ? 0 : 1;
+    }
+
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    const QString outputDir = parser.value(outputOption);
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        err << "Cannot create output directory: " << outputDir << Qt::endl;
+        return 1;
+    }
+
+    const bool validate = !parser.isSet(noValidateOption);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Файлы независимы; каждая конвертация сама распараллеливает кодирование тем.
+    // std::function дает result_type, необходимый QtConcurrent в Qt 5
+    const std::function<CompileResult(const QString&)> compile = [&outputDir, validate](const QString& file) {
+        return compileCourse(file, outputDir, validate);
+    };
+    const QList<CompileResult> results = QtConcurrent::blockingMapped<QList<CompileResult>>(files, compile);
+
+    const qint64 totalMs = timer.elapsed();
+
+    int failedFiles = 0;
+    int invalidFiles = 0;
+    int totalTopics = 0;
+    qint64 totalInput = 0;
+    qint64 totalOutput = 0;
+    for (const CompileResult& result : results) {
+        if (!result.converted) {
+            ++failedFiles;
+            err << "FAILED  " << result.jsonFilePath << Qt::endl;
+            continue;
+        }
+
+        totalTopics += result.topicCount;
+        totalInput += result.inputBytes;
+        totalOutput += result.outputBytes;
+
+        if (!result.report.failedTopics.isEmpty()) {
+            ++invalidFiles;
+            err << "INVALID " << result.binaryFilePath << ": " << result.report.summary() << Qt::endl;
+        } else if (!quiet) {
+            out << "OK      " << result.binaryFilePath << " (" << result.topicCount << " topics, "
+                << result.inputBytes << " -> " << result.outputBytes << " bytes, " << result.elapsedMs << " ms";
+            if (validate && !result.report.isClean()) {
+                out << "; " << result.report.summary();
+            }
+            out << ")" << Qt::endl;
+        }
+    }
+
+    out << "Compiled " << (results.size() - failedFiles) << "/" << results.size() << " files, "
+        << totalTopics << " topics in " << totalMs << " ms using "
+        << QThreadPool::globalInstance()->maxThreadCount() << " threads ("
+        << QString::number(megabytesPerSecond(totalInput, totalMs), 'f', 1) << " MB/s JSON, "
+        << QString::number(totalMs > 0 ? totalTopics * 1000.0 / totalMs : 0.0, 'f', 0) << " topics/s)"
+        << Qt::endl;
+
+    return failedFiles > 0 || invalidFiles > 0 ? 1 : 0;
+}